@@ -0,0 +1,52 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+namespace bmstu {
+    inline constexpr size_t cache_line_size = 64;
+
+    // Allocator whose blocks start on an Alignment boundary, through the aligned forms of operator new and
+    // delete. raw_memory reads the alignment member, so vector::data() can promise it to the compiler.
+    template<typename T, size_t Alignment = alignof(T)>
+    class aligned_allocator {
+        static_assert(std::has_single_bit(Alignment), "Alignment must be a power of two");
+        static_assert(Alignment >= alignof(T), "Alignment must not be weaker than the type's own");
+
+    public:
+        using value_type = T;
+        using propagate_on_container_move_assignment = std::true_type;
+        using is_always_equal = std::true_type;
+
+        static constexpr size_t alignment = Alignment;
+
+        template<typename U>
+        struct rebind {
+            using other = aligned_allocator<U, std::max(Alignment, alignof(U))>;
+        };
+
+        aligned_allocator() = default;
+
+        template<typename U, size_t A>
+        aligned_allocator(const aligned_allocator<U, A> &) noexcept {}
+
+        T *allocate(size_t n) {
+            if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+                throw std::bad_array_new_length();
+            }
+            return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t{Alignment}));
+        }
+
+        void deallocate(T *ptr, size_t n) noexcept {
+            ::operator delete(ptr, n * sizeof(T), std::align_val_t{Alignment});
+        }
+
+        friend bool operator==(const aligned_allocator &, const aligned_allocator &) noexcept {
+            return true;
+        }
+    };
+}
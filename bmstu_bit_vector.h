@@ -0,0 +1,402 @@
+#pragma once
+
+#include "growth_policy.h"
+#include "indexed_iterator.h"
+#include "raw_memory.h"
+#include "simd.h"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+
+namespace bmstu {
+    // Vector of flags packed 64 to a word. Bits past size() in the last word are always zero, so count,
+    // comparison and search work on whole words. The bulk operators combine vectors of equal size a word
+    // block at a time through the simd kernels.
+    template<typename Allocator = std::allocator<uint64_t>>
+    class bit_vector {
+        using word_type = uint64_t;
+        using memory_type = raw_memory<word_type, Allocator>;
+
+        static constexpr size_t word_bits = 64;
+
+    public:
+        using value_type = bool;
+        using allocator_type = Allocator;
+        using size_type = size_t;
+
+        class reference {
+        public:
+            reference(word_type *word, word_type mask) noexcept : word_(word), mask_(mask) {}
+
+            reference(const reference &other) = default;
+
+            reference &operator=(bool value) noexcept {
+                if (value) {
+                    *word_ |= mask_;
+                } else {
+                    *word_ &= ~mask_;
+                }
+                return *this;
+            }
+
+            reference &operator=(const reference &other) noexcept {
+                return *this = static_cast<bool>(other);
+            }
+
+            operator bool() const noexcept {
+                return (*word_ & mask_) != 0;
+            }
+
+            bool operator~() const noexcept {
+                return !static_cast<bool>(*this);
+            }
+
+            void flip() noexcept {
+                *word_ ^= mask_;
+            }
+
+        private:
+            word_type *word_;
+            word_type mask_;
+        };
+
+        using const_reference = bool;
+        using iterator = indexed_iterator<bit_vector, bool, reference>;
+        using const_iterator = indexed_iterator<bit_vector, const bool, bool>;
+
+        static constexpr size_t npos = static_cast<size_t>(-1);
+
+        bit_vector() = default;
+
+        explicit bit_vector(const Allocator &alloc) noexcept : words_(alloc) {}
+
+        explicit bit_vector(size_t size, bool value = false, const Allocator &alloc = Allocator()) : words_(alloc) {
+            resize(size, value);
+        }
+
+        bit_vector(std::initializer_list<bool> ilist, const Allocator &alloc = Allocator()) : words_(alloc) {
+            reserve(ilist.size());
+            for (bool value: ilist) {
+                push_back(value);
+            }
+        }
+
+        bit_vector(const bit_vector &other) : words_(words_for_(other.size_), std::allocator_traits<Allocator>::
+                select_on_container_copy_construction(other.words_.get_allocator())), size_(other.size_) {
+            std::copy_n(other.words_.get_address(), word_count(), words_.get_address());
+        }
+
+        bit_vector(bit_vector &&other) noexcept : words_(std::move(other.words_)),
+                                                  size_(std::exchange(other.size_, 0)) {}
+
+        bit_vector &operator=(const bit_vector &other) {
+            if (this != &other) {
+                bit_vector copy(other);
+                swap(copy);
+            }
+            return *this;
+        }
+
+        bit_vector &operator=(bit_vector &&other) noexcept {
+            if (this != &other) {
+                bit_vector tmp(std::move(other));
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        allocator_type get_allocator() const noexcept {
+            return words_.get_allocator();
+        }
+
+        iterator begin() noexcept {
+            return {this, 0};
+        }
+
+        iterator end() noexcept {
+            return {this, size_};
+        }
+
+        const_iterator begin() const noexcept {
+            return {this, 0};
+        }
+
+        const_iterator end() const noexcept {
+            return {this, size_};
+        }
+
+        const_iterator cbegin() const noexcept {
+            return begin();
+        }
+
+        const_iterator cend() const noexcept {
+            return end();
+        }
+
+        reference operator[](size_t index) noexcept {
+            assert(index < size_);
+            return {words_.get_address() + index / word_bits, mask_(index)};
+        }
+
+        bool operator[](size_t index) const noexcept {
+            assert(index < size_);
+            return (words_[index / word_bits] & mask_(index)) != 0;
+        }
+
+        reference at(size_t index) {
+            if (index >= size_) {
+                throw std::out_of_range("Invalid index");
+            }
+            return (*this)[index];
+        }
+
+        bool at(size_t index) const {
+            if (index >= size_) {
+                throw std::out_of_range("Invalid index");
+            }
+            return (*this)[index];
+        }
+
+        bool test(size_t index) const {
+            return at(index);
+        }
+
+        void set(size_t index, bool value = true) {
+            at(index) = value;
+        }
+
+        void reset(size_t index) {
+            at(index) = false;
+        }
+
+        void flip(size_t index) {
+            at(index).flip();
+        }
+
+        void set() noexcept {
+            std::fill_n(words_.get_address(), word_count(), ~word_type{0});
+            clear_tail_();
+        }
+
+        void reset() noexcept {
+            std::fill_n(words_.get_address(), word_count(), word_type{0});
+        }
+
+        void flip() noexcept {
+            simd::invert(words_.get_address(), word_count());
+            clear_tail_();
+        }
+
+        size_t count() const noexcept {
+            return simd::popcount(words_.get_address(), word_count());
+        }
+
+        bool any() const noexcept {
+            return find_first() != npos;
+        }
+
+        bool none() const noexcept {
+            return !any();
+        }
+
+        bool all() const noexcept {
+            return count() == size_;
+        }
+
+        // Index of the first set bit, or npos.
+        size_t find_first() const noexcept {
+            return find_from_word_(0);
+        }
+
+        // Index of the first set bit after pos, or npos.
+        size_t find_next(size_t pos) const noexcept {
+            if (pos == npos || pos + 1 >= size_) {
+                return npos;
+            }
+            ++pos;
+            const size_t word = pos / word_bits;
+            const word_type rest = words_[word] >> (pos % word_bits);
+            if (rest != 0) {
+                return pos + std::countr_zero(rest);
+            }
+            return find_from_word_(word + 1);
+        }
+
+        void clear() noexcept {
+            size_ = 0;
+        }
+
+        void swap(bit_vector &other) noexcept {
+            words_.swap(other.words_);
+            std::swap(size_, other.size_);
+        }
+
+        friend void swap(bit_vector &left, bit_vector &right) noexcept {
+            left.swap(right);
+        }
+
+        void reserve(size_t new_capacity) {
+            if (new_capacity > capacity()) {
+                change_capacity_(words_for_(new_capacity));
+            }
+        }
+
+        void shrink_to_fit() {
+            if (words_for_(size_) < words_.capacity()) {
+                change_capacity_(words_for_(size_));
+            }
+        }
+
+        void resize(size_t new_size, bool value = false) {
+            if (new_size <= size_) {
+                size_ = new_size;
+                clear_tail_();
+                return;
+            }
+            reserve(new_size);
+            const size_t old_words = word_count();
+            const size_t new_words = words_for_(new_size);
+            std::fill(words_.get_address() + old_words, words_.get_address() + new_words,
+                      value ? ~word_type{0} : word_type{0});
+            if (value && size_ % word_bits != 0) {
+                words_[old_words - 1] |= ~word_type{0} << (size_ % word_bits);
+            }
+            size_ = new_size;
+            clear_tail_();
+        }
+
+        void push_back(bool value) {
+            if (size_ == capacity()) {
+                change_capacity_(grow_2x::next_capacity(words_.capacity(), words_.capacity() + 1, sizeof(word_type)));
+            }
+            if (size_ % word_bits == 0) {
+                words_[size_ / word_bits] = 0;
+            }
+            ++size_;
+            (*this)[size_ - 1] = value;
+        }
+
+        void pop_back() noexcept {
+            assert(size_ != 0);
+            --size_;
+            clear_tail_();
+        }
+
+        size_t size() const noexcept {
+            return size_;
+        }
+
+        size_t capacity() const noexcept {
+            return words_.capacity() * word_bits;
+        }
+
+        bool empty() const noexcept {
+            return (size_ == 0);
+        }
+
+        size_t word_count() const noexcept {
+            return words_for_(size_);
+        }
+
+        // The packed words; bit i is bit i % 64 of word i / 64.
+        const word_type *data() const noexcept {
+            return words_.get_address();
+        }
+
+        bit_vector &operator&=(const bit_vector &other) noexcept {
+            return combine_<simd::word_op::bit_and>(other);
+        }
+
+        bit_vector &operator|=(const bit_vector &other) noexcept {
+            return combine_<simd::word_op::bit_or>(other);
+        }
+
+        bit_vector &operator^=(const bit_vector &other) noexcept {
+            return combine_<simd::word_op::bit_xor>(other);
+        }
+
+        friend bit_vector operator&(bit_vector l, const bit_vector &r) {
+            l &= r;
+            return l;
+        }
+
+        friend bit_vector operator|(bit_vector l, const bit_vector &r) {
+            l |= r;
+            return l;
+        }
+
+        friend bit_vector operator^(bit_vector l, const bit_vector &r) {
+            l ^= r;
+            return l;
+        }
+
+        friend bit_vector operator~(bit_vector v) {
+            v.flip();
+            return v;
+        }
+
+        friend bool operator==(const bit_vector &l, const bit_vector &r) {
+            return l.size_ == r.size_ && simd::equal(l.words_.get_address(), r.words_.get_address(), l.word_count());
+        }
+
+        friend bool operator!=(const bit_vector &l, const bit_vector &r) {
+            return !(l == r);
+        }
+
+        template<class S>
+        friend S &operator<<(S &os, const bit_vector &other) {
+            os << "[";
+            for (size_t i = 0; i != other.size_; ++i) {
+                os << (i == 0 ? "" : ", ") << other[i];
+            }
+            os << "]";
+            return os;
+        }
+
+    private:
+        static constexpr size_t words_for_(size_t bits) noexcept {
+            return (bits + word_bits - 1) / word_bits;
+        }
+
+        static constexpr word_type mask_(size_t index) noexcept {
+            return word_type{1} << (index % word_bits);
+        }
+
+        void clear_tail_() noexcept {
+            if (size_ % word_bits != 0) {
+                words_[size_ / word_bits] &= ~(~word_type{0} << (size_ % word_bits));
+            }
+        }
+
+        size_t find_from_word_(size_t word) const noexcept {
+            const size_t words = word_count();
+            const word_type *data = words_.get_address();
+            for (; word < words; ++word) {
+                if (data[word] != 0) {
+                    return word * word_bits + std::countr_zero(data[word]);
+                }
+            }
+            return npos;
+        }
+
+        template<simd::word_op Op>
+        bit_vector &combine_(const bit_vector &other) noexcept {
+            assert(size_ == other.size_);
+            simd::combine<Op>(words_.get_address(), other.words_.get_address(), word_count());
+            return *this;
+        }
+
+        void change_capacity_(size_t words) {
+            memory_type new_words(words, words_.get_allocator());
+            std::copy_n(words_.get_address(), word_count(), new_words.get_address());
+            words_.swap(new_words);
+        }
+
+        memory_type words_;
+        size_t size_ = 0;
+    };
+}
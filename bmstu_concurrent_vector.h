@@ -0,0 +1,238 @@
+#pragma once
+
+#include "indexed_iterator.h"
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace bmstu {
+    // Append-only vector for many concurrent writers. Storage is a table of segments whose sizes double
+    // (segment 0 and 1 hold first_segment elements each), so an element never moves once constructed and
+    // references to it stay valid until the vector is destroyed.
+    //
+    // push_back, emplace_back and grow_by claim their indices with one fetch_add and may be called from any
+    // number of threads at once, together with operator[], at, size and iteration. size() is the published
+    // prefix: the longest run of elements, starting at 0, whose construction has finished. An element whose
+    // constructor throws is never published, so the prefix stops growing at it.
+    template<typename T, typename Allocator = std::allocator<T>>
+    class concurrent_vector {
+        struct slot {
+            alignas(T) std::byte storage[sizeof(T)];
+            std::atomic<bool> ready{false};
+
+            T *get() noexcept {
+                return std::launder(reinterpret_cast<T *>(storage));
+            }
+        };
+
+        using slot_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<slot>;
+        using slot_traits = std::allocator_traits<slot_allocator>;
+
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+        using size_type = size_t;
+        using iterator = indexed_iterator<concurrent_vector, T>;
+        using const_iterator = indexed_iterator<concurrent_vector, const T>;
+
+        static constexpr size_t first_segment = 16;
+        static constexpr size_t max_segments = 64 - std::countr_zero(first_segment) + 1;
+
+        concurrent_vector() = default;
+
+        explicit concurrent_vector(const Allocator &alloc) : alloc_(alloc) {}
+
+        concurrent_vector(const concurrent_vector &) = delete;
+
+        concurrent_vector &operator=(const concurrent_vector &) = delete;
+
+        ~concurrent_vector() {
+            const size_t claimed = claimed_.load(std::memory_order_acquire);
+            for (size_t k = 0; k < max_segments && segment_base_(k) < claimed; ++k) {
+                slot *segment = segments_[k].load(std::memory_order_acquire);
+                if (!segment) {
+                    continue;
+                }
+                const size_t n = std::min(segment_size_(k), claimed - segment_base_(k));
+                for (size_t i = 0; i < n; ++i) {
+                    if (segment[i].ready.load(std::memory_order_relaxed)) {
+                        std::destroy_at(segment[i].get());
+                    }
+                }
+            }
+            slot_allocator alloc(alloc_);
+            for (size_t k = 0; k < max_segments; ++k) {
+                if (slot *segment = segments_[k].load(std::memory_order_relaxed)) {
+                    std::destroy_n(segment, segment_size_(k));
+                    slot_traits::deallocate(alloc, segment, segment_size_(k));
+                }
+            }
+        }
+
+        allocator_type get_allocator() const noexcept {
+            return alloc_;
+        }
+
+        template<typename ... Args>
+        T &emplace_back(Args &&... args) {
+            return *construct_(claimed_.fetch_add(1, std::memory_order_relaxed), std::forward<Args>(args) ...);
+        }
+
+        T &push_back(const T &value) {
+            return emplace_back(value);
+        }
+
+        T &push_back(T &&value) {
+            return emplace_back(std::move(value));
+        }
+
+        // Appends n value-initialized elements and returns an iterator to the first of them.
+        iterator grow_by(size_t n) {
+            const size_t first = claimed_.fetch_add(n, std::memory_order_relaxed);
+            for (size_t i = first; i < first + n; ++i) {
+                construct_(i);
+            }
+            return {this, first};
+        }
+
+        iterator grow_by(size_t n, const T &value) {
+            const size_t first = claimed_.fetch_add(n, std::memory_order_relaxed);
+            for (size_t i = first; i < first + n; ++i) {
+                construct_(i, value);
+            }
+            return {this, first};
+        }
+
+        // Allocates every segment needed to hold n elements so later appends below n never allocate.
+        void reserve(size_t n) {
+            for (size_t k = 0; k < max_segments && segment_base_(k) < n; ++k) {
+                segment_(k);
+            }
+        }
+
+        T &operator[](size_t index) noexcept {
+            return *slot_(index).get();
+        }
+
+        const T &operator[](size_t index) const noexcept {
+            return *const_cast<concurrent_vector &>(*this).slot_(index).get();
+        }
+
+        T &at(size_t index) {
+            if (!ready_(index)) {
+                throw std::out_of_range("Invalid index");
+            }
+            return (*this)[index];
+        }
+
+        const T &at(size_t index) const {
+            return const_cast<concurrent_vector &>(*this).at(index);
+        }
+
+        size_t size() const noexcept {
+            size_t published = published_.load(std::memory_order_acquire);
+            size_t prefix = published;
+            while (ready_(prefix)) {
+                ++prefix;
+            }
+            while (published < prefix &&
+                   !published_.compare_exchange_weak(published, prefix, std::memory_order_acq_rel)) {
+            }
+            return std::max(published, prefix);
+        }
+
+        bool empty() const noexcept {
+            return size() == 0;
+        }
+
+        // Elements claimed so far, including ones still being constructed.
+        size_t claimed_size() const noexcept {
+            return claimed_.load(std::memory_order_relaxed);
+        }
+
+        iterator begin() noexcept {
+            return {this, 0};
+        }
+
+        iterator end() noexcept {
+            return {this, size()};
+        }
+
+        const_iterator begin() const noexcept {
+            return {this, 0};
+        }
+
+        const_iterator end() const noexcept {
+            return {this, size()};
+        }
+
+    private:
+        static constexpr size_t segment_of_(size_t index) noexcept {
+            return std::bit_width(index / first_segment);
+        }
+
+        static constexpr size_t segment_base_(size_t k) noexcept {
+            return k == 0 ? 0 : first_segment << (k - 1);
+        }
+
+        static constexpr size_t segment_size_(size_t k) noexcept {
+            return k == 0 ? first_segment : first_segment << (k - 1);
+        }
+
+        slot &slot_(size_t index) noexcept {
+            const size_t k = segment_of_(index);
+            slot *segment = segments_[k].load(std::memory_order_acquire);
+            assert(segment != nullptr);
+            return segment[index - segment_base_(k)];
+        }
+
+        bool ready_(size_t index) const noexcept {
+            if (index >= claimed_.load(std::memory_order_acquire)) {
+                return false;
+            }
+            const size_t k = segment_of_(index);
+            slot *segment = segments_[k].load(std::memory_order_acquire);
+            return segment && segment[index - segment_base_(k)].ready.load(std::memory_order_acquire);
+        }
+
+        // The first thread to need a segment allocates it; threads that lose the race free their copy. Segments
+        // are owned through segments_ alone and freed by the destructor with the vector's own allocator.
+        slot *segment_(size_t k) {
+            slot *segment = segments_[k].load(std::memory_order_acquire);
+            if (segment) {
+                return segment;
+            }
+            slot_allocator alloc(alloc_);
+            slot *fresh = std::to_address(slot_traits::allocate(alloc, segment_size_(k)));
+            std::uninitialized_value_construct_n(fresh, segment_size_(k));
+            if (!segments_[k].compare_exchange_strong(segment, fresh, std::memory_order_acq_rel,
+                                                      std::memory_order_acquire)) {
+                std::destroy_n(fresh, segment_size_(k));
+                slot_traits::deallocate(alloc, fresh, segment_size_(k));
+                return segment;
+            }
+            return fresh;
+        }
+
+        template<typename ... Args>
+        T *construct_(size_t index, Args &&... args) {
+            const size_t k = segment_of_(index);
+            slot &target = segment_(k)[index - segment_base_(k)];
+            T *value = new(target.storage) T(std::forward<Args>(args) ...);
+            target.ready.store(true, std::memory_order_release);
+            return value;
+        }
+
+        [[no_unique_address]] Allocator alloc_;
+        std::array<std::atomic<slot *>, max_segments> segments_{};
+        std::atomic<size_t> claimed_{0};
+        mutable std::atomic<size_t> published_{0};
+    };
+}
@@ -0,0 +1,471 @@
+#pragma once
+
+#include "bmstu_static_vector.h"
+#include "bmstu_vector.h"
+#include "indexed_iterator.h"
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <memory>
+
+namespace bmstu {
+    // Owning handle to a Payload shared through an atomic reference count. Copies only bump the count;
+    // mutate() gives exclusive access, copying the payload first if anyone else still holds it.
+    template<typename Payload, typename Allocator>
+    class cow_handle {
+        struct block {
+            template<typename ... Args>
+            explicit block(Args &&... args) : payload(std::forward<Args>(args) ...) {}
+
+            std::atomic<size_t> refs{1};
+            Payload payload;
+        };
+
+        using block_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<block>;
+        using block_traits = std::allocator_traits<block_allocator>;
+
+    public:
+        cow_handle() = default;
+
+        explicit cow_handle(const Allocator &alloc) noexcept : alloc_(alloc) {}
+
+        template<typename ... Args>
+        static cow_handle make(const Allocator &alloc, Args &&... args) {
+            cow_handle handle(alloc);
+            block *fresh = block_traits::allocate(handle.alloc_, 1);
+            try {
+                block_traits::construct(handle.alloc_, fresh, std::forward<Args>(args) ...);
+            } catch (...) {
+                block_traits::deallocate(handle.alloc_, fresh, 1);
+                throw;
+            }
+            handle.block_ = fresh;
+            return handle;
+        }
+
+        cow_handle(const cow_handle &other) noexcept : alloc_(other.alloc_), block_(other.block_) {
+            if (block_) {
+                block_->refs.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        cow_handle(cow_handle &&other) noexcept : alloc_(other.alloc_), block_(std::exchange(other.block_, nullptr)) {}
+
+        cow_handle &operator=(cow_handle other) noexcept {
+            swap(other);
+            return *this;
+        }
+
+        void swap(cow_handle &other) noexcept {
+            if constexpr (block_traits::propagate_on_container_swap::value) {
+                using std::swap;
+                swap(alloc_, other.alloc_);
+            } else {
+                assert(alloc_ == other.alloc_);
+            }
+            std::swap(block_, other.block_);
+        }
+
+        ~cow_handle() {
+            if (block_ && block_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                block_traits::destroy(alloc_, block_);
+                block_traits::deallocate(alloc_, block_, 1);
+            }
+        }
+
+        explicit operator bool() const noexcept {
+            return block_ != nullptr;
+        }
+
+        const Payload &operator*() const noexcept {
+            return block_->payload;
+        }
+
+        const Payload *operator->() const noexcept {
+            return &block_->payload;
+        }
+
+        size_t use_count() const noexcept {
+            return block_ ? block_->refs.load(std::memory_order_acquire) : 0;
+        }
+
+        Allocator get_allocator() const noexcept {
+            return Allocator(alloc_);
+        }
+
+        Payload &mutate() {
+            if (!block_) {
+                *this = make_payload_();
+            } else if (use_count() != 1) {
+                *this = make_payload_(std::as_const(block_->payload));
+            }
+            return block_->payload;
+        }
+
+    private:
+        // Payloads that take an allocator get the handle's, so a detached copy stays with the same allocator.
+        template<typename ... Args>
+        cow_handle make_payload_(Args &&... args) const {
+            const Allocator alloc = get_allocator();
+            if constexpr (std::uses_allocator_v<Payload, Allocator>) {
+                return make(alloc, std::forward<Args>(args) ..., alloc);
+            } else {
+                return make(alloc, std::forward<Args>(args) ...);
+            }
+        }
+
+        [[no_unique_address]] block_allocator alloc_;
+        block *block_ = nullptr;
+    };
+
+    // Vector whose copies share one buffer until one of them is modified. Copying is O(1); the first
+    // mutation through a copy that is not the only owner copies the elements. Const member functions never
+    // copy, non-const ones that can hand out a mutable reference (operator[], at, begin, end) always
+    // detach. Different cow_vector objects sharing a buffer may be used from different threads.
+    template<typename T, typename Allocator = std::allocator<T>>
+    class cow_vector {
+        using vector_type = vector<T, Allocator>;
+        using handle_type = cow_handle<vector_type, Allocator>;
+
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+        using size_type = size_t;
+        using iterator = T *;
+        using const_iterator = const T *;
+
+        cow_vector() = default;
+
+        explicit cow_vector(const Allocator &alloc) noexcept : data_(alloc) {}
+
+        explicit cow_vector(size_t size, const Allocator &alloc = Allocator()) :
+                data_(handle_type::make(alloc, size, alloc)) {}
+
+        cow_vector(std::initializer_list<T> ilist, const Allocator &alloc = Allocator()) :
+                data_(handle_type::make(alloc, ilist, alloc)) {}
+
+        template<std::input_iterator It>
+        cow_vector(It first, It last, const Allocator &alloc = Allocator()) :
+                data_(handle_type::make(alloc, first, last, alloc)) {}
+
+        explicit cow_vector(vector_type elements) :
+                data_(handle_type::make(elements.get_allocator(), std::move(elements))) {}
+
+        allocator_type get_allocator() const noexcept {
+            return data_.get_allocator();
+        }
+
+        size_t use_count() const noexcept {
+            return data_.use_count();
+        }
+
+        const T *data() const noexcept {
+            return empty() ? nullptr : &(*data_)[0];
+        }
+
+        T *data() {
+            return empty() ? nullptr : &data_.mutate()[0];
+        }
+
+        const_iterator begin() const noexcept {
+            return data();
+        }
+
+        const_iterator end() const noexcept {
+            return data() + size();
+        }
+
+        const_iterator cbegin() const noexcept {
+            return begin();
+        }
+
+        const_iterator cend() const noexcept {
+            return end();
+        }
+
+        iterator begin() {
+            return data();
+        }
+
+        iterator end() {
+            return data() + size();
+        }
+
+        const T &operator[](size_t index) const noexcept {
+            assert(index < size());
+            return (*data_)[index];
+        }
+
+        T &operator[](size_t index) {
+            assert(index < size());
+            return data_.mutate()[index];
+        }
+
+        const T &at(size_t index) const {
+            if (index >= size()) {
+                throw std::out_of_range("Invalid index");
+            }
+            return (*data_)[index];
+        }
+
+        T &at(size_t index) {
+            if (index >= size()) {
+                throw std::out_of_range("Invalid index");
+            }
+            return data_.mutate()[index];
+        }
+
+        // Drops this owner's reference instead of destroying elements other copies still see.
+        void clear() {
+            if (data_.use_count() > 1) {
+                data_ = handle_type(get_allocator());
+            } else if (data_) {
+                data_.mutate().clear();
+            }
+        }
+
+        void swap(cow_vector &other) noexcept {
+            data_.swap(other.data_);
+        }
+
+        friend void swap(cow_vector &left, cow_vector &right) noexcept {
+            left.swap(right);
+        }
+
+        void reserve(size_t new_capacity) {
+            data_.mutate().reserve(new_capacity);
+        }
+
+        void resize(size_t new_size) {
+            data_.mutate().resize(new_size);
+        }
+
+        void pop_back() {
+            assert(size() != 0);
+            data_.mutate().pop_back();
+        }
+
+        template<typename ... Args>
+        T &emplace_back(Args &&... args) {
+            return data_.mutate().emplace_back(std::forward<Args>(args) ...);
+        }
+
+        template<typename ... Args>
+        iterator emplace(const_iterator pos, Args &&... args) {
+            const size_t index = pos - cbegin();
+            vector_type &elements = data_.mutate();
+            elements.emplace(elements.begin() + index, std::forward<Args>(args) ...);
+            return data() + index;
+        }
+
+        iterator erase(const_iterator pos) {
+            const size_t index = pos - cbegin();
+            vector_type &elements = data_.mutate();
+            elements.erase(elements.begin() + index);
+            return data() + index;
+        }
+
+        template<typename Type>
+        iterator incert(const_iterator pos, Type &&value) {
+            return emplace(pos, std::forward<Type>(value));
+        }
+
+        template<typename Type>
+        void push_back(Type &&value) {
+            emplace_back(std::forward<Type>(value));
+        }
+
+        size_t size() const noexcept {
+            return data_ ? data_->size() : 0;
+        }
+
+        size_t capacity() const noexcept {
+            return data_ ? data_->capacity() : 0;
+        }
+
+        bool empty() const noexcept {
+            return size() == 0;
+        }
+
+        friend bool operator==(const cow_vector &l, const cow_vector &r) {
+            return std::equal(l.begin(), l.end(), r.begin(), r.end());
+        }
+
+        friend bool operator!=(const cow_vector &l, const cow_vector &r) {
+            return !(l == r);
+        }
+
+        friend bool operator<(const cow_vector &l, const cow_vector &r) {
+            return std::lexicographical_compare(l.begin(), l.end(), r.begin(), r.end());
+        }
+
+        friend bool operator>(const cow_vector &l, const cow_vector &r) {
+            return (r < l);
+        }
+
+        friend bool operator<=(const cow_vector &l, const cow_vector &r) {
+            return !(r < l);
+        }
+
+        friend bool operator>=(const cow_vector &l, const cow_vector &r) {
+            return !(l < r);
+        }
+
+        template<class S>
+        friend S &operator<<(S &os, const cow_vector &other) {
+            os << "[";
+            for (size_t i = 0; i != other.size(); ++i) {
+                os << (i == 0 ? "" : ", ") << other[i];
+            }
+            os << "]";
+            return os;
+        }
+
+    private:
+        handle_type data_;
+    };
+
+    template<typename T>
+    inline constexpr size_t default_persistent_chunk_size = std::bit_floor(std::max<size_t>(1, 1024 / sizeof(T)));
+
+    // Persistent vector: a shared table of shared fixed-size chunks. Copying is O(1). A mutation copies
+    // the chunk table if it is shared (one pointer per chunk) and then only the chunk it touches, so a
+    // snapshot and its successor share every chunk the mutation did not reach.
+    template<typename T, size_t ChunkSize = default_persistent_chunk_size<T>, typename Allocator = std::allocator<T>>
+    class persistent_vector {
+        using chunk_type = static_vector<T, ChunkSize>;
+        using chunk_handle = cow_handle<chunk_type, Allocator>;
+        using table_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<chunk_handle>;
+        using table_type = vector<chunk_handle, table_allocator>;
+        using table_handle = cow_handle<table_type, Allocator>;
+
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+        using size_type = size_t;
+        using const_iterator = indexed_iterator<persistent_vector, const T>;
+        using iterator = const_iterator;
+
+        static constexpr size_t chunk_size = ChunkSize;
+
+        persistent_vector() = default;
+
+        explicit persistent_vector(const Allocator &alloc) noexcept : alloc_(alloc), table_(alloc) {}
+
+        persistent_vector(std::initializer_list<T> ilist, const Allocator &alloc = Allocator()) :
+                persistent_vector(alloc) {
+            for (const T &value: ilist) {
+                push_back(value);
+            }
+        }
+
+        allocator_type get_allocator() const noexcept {
+            return alloc_;
+        }
+
+        const_iterator begin() const noexcept {
+            return {this, 0};
+        }
+
+        const_iterator end() const noexcept {
+            return {this, size_};
+        }
+
+        const T &operator[](size_t index) const noexcept {
+            assert(index < size_);
+            return (*(*table_)[index / ChunkSize])[index % ChunkSize];
+        }
+
+        const T &at(size_t index) const {
+            if (index >= size_) {
+                throw std::out_of_range("Invalid index");
+            }
+            return (*this)[index];
+        }
+
+        // Mutable access to one element; copies the table and that element's chunk if they are shared.
+        T &mutable_at(size_t index) {
+            if (index >= size_) {
+                throw std::out_of_range("Invalid index");
+            }
+            return table_.mutate()[index / ChunkSize].mutate()[index % ChunkSize];
+        }
+
+        void set(size_t index, T value) {
+            mutable_at(index) = std::move(value);
+        }
+
+        template<typename ... Args>
+        const T &emplace_back(Args &&... args) {
+            table_type &table = table_.mutate();
+            if (size_ % ChunkSize == 0) {
+                table.push_back(chunk_handle::make(alloc_));
+            }
+            const T &value = table[table.size() - 1].mutate().emplace_back(std::forward<Args>(args) ...);
+            ++size_;
+            return value;
+        }
+
+        template<typename Type>
+        void push_back(Type &&value) {
+            emplace_back(std::forward<Type>(value));
+        }
+
+        void pop_back() {
+            assert(size_ != 0);
+            table_type &table = table_.mutate();
+            chunk_handle &last = table[table.size() - 1];
+            if ((size_ - 1) % ChunkSize == 0) {
+                table.pop_back();
+            } else {
+                last.mutate().pop_back();
+            }
+            --size_;
+        }
+
+        void clear() {
+            table_ = table_handle(alloc_);
+            size_ = 0;
+        }
+
+        size_t size() const noexcept {
+            return size_;
+        }
+
+        bool empty() const noexcept {
+            return size_ == 0;
+        }
+
+        // Number of chunks this vector shares with other, a measure of how much two snapshots overlap.
+        size_t shared_chunks(const persistent_vector &other) const noexcept {
+            size_t shared = 0;
+            for (size_t i = 0; i * ChunkSize < std::min(size_, other.size_); ++i) {
+                shared += &*(*table_)[i] == &*(*other.table_)[i];
+            }
+            return shared;
+        }
+
+        friend bool operator==(const persistent_vector &l, const persistent_vector &r) {
+            return std::equal(l.begin(), l.end(), r.begin(), r.end());
+        }
+
+        friend bool operator!=(const persistent_vector &l, const persistent_vector &r) {
+            return !(l == r);
+        }
+
+        template<class S>
+        friend S &operator<<(S &os, const persistent_vector &other) {
+            os << "[";
+            for (size_t i = 0; i != other.size_; ++i) {
+                os << (i == 0 ? "" : ", ") << other[i];
+            }
+            os << "]";
+            return os;
+        }
+
+    private:
+        [[no_unique_address]] Allocator alloc_;
+        table_handle table_;
+        size_t size_ = 0;
+    };
+}
@@ -0,0 +1,305 @@
+#pragma once
+
+#include "growth_policy.h"
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <fcntl.h>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+
+namespace bmstu {
+    struct mapped_header {
+        static constexpr uint64_t magic_value = 0x4345565554534D42;  // "BMSTUVEC" read as little-endian
+        static constexpr uint32_t current_version = 1;
+
+        uint64_t magic;
+        uint32_t version;
+        uint32_t type_size;
+        uint32_t type_alignment;
+        uint32_t data_offset;
+        uint64_t size;
+        uint64_t capacity;
+    };
+
+    enum class open_mode {
+        read_only,
+        read_write
+    };
+
+    // Vector of trivially copyable records stored in a memory-mapped file: the header above followed by the
+    // elements. Opening an existing file validates the header and maps it, there is no deserialization step.
+    template<typename T, typename GrowthPolicy = grow_2x>
+    class mapped_vector {
+        static_assert(std::is_trivially_copyable_v<T>, "mapped_vector stores raw bytes of T in a file");
+
+    public:
+        using value_type = T;
+        using size_type = size_t;
+        using iterator = T *;
+        using const_iterator = const T *;
+
+        static constexpr size_t data_offset =
+                (sizeof(mapped_header) + alignof(T) - 1) / alignof(T) * alignof(T);
+
+        explicit mapped_vector(const std::string &path, open_mode mode = open_mode::read_write) : mode_(mode) {
+            const int flags = mode == open_mode::read_only ? O_RDONLY : (O_RDWR | O_CREAT);
+            fd_ = ::open(path.c_str(), flags, 0644);
+            if (fd_ < 0) {
+                throw_errno_("open " + path);
+            }
+            try {
+                struct stat st{};
+                if (::fstat(fd_, &st) != 0) {
+                    throw_errno_("fstat " + path);
+                }
+                if (st.st_size == 0 && mode == open_mode::read_write) {
+                    resize_file_(data_offset);
+                    map_(data_offset);
+                    *header_() = mapped_header{mapped_header::magic_value, mapped_header::current_version,
+                                               sizeof(T), alignof(T), data_offset, 0, 0};
+                } else {
+                    if (static_cast<size_t>(st.st_size) < data_offset) {
+                        throw std::runtime_error(path + ": file is too small for a mapped_vector header");
+                    }
+                    map_(static_cast<size_t>(st.st_size));
+                    validate_(path);
+                }
+            } catch (...) {
+                release_();
+                throw;
+            }
+        }
+
+        mapped_vector(const mapped_vector &) = delete;
+
+        mapped_vector &operator=(const mapped_vector &) = delete;
+
+        mapped_vector(mapped_vector &&other) noexcept : fd_(std::exchange(other.fd_, -1)),
+                                                        mapping_(std::exchange(other.mapping_, nullptr)),
+                                                        mapping_size_(std::exchange(other.mapping_size_, 0)),
+                                                        mode_(other.mode_) {}
+
+        mapped_vector &operator=(mapped_vector &&other) noexcept {
+            if (this != &other) {
+                release_();
+                fd_ = std::exchange(other.fd_, -1);
+                mapping_ = std::exchange(other.mapping_, nullptr);
+                mapping_size_ = std::exchange(other.mapping_size_, 0);
+                mode_ = other.mode_;
+            }
+            return *this;
+        }
+
+        ~mapped_vector() {
+            release_();
+        }
+
+        // The mutable accessors throw std::logic_error on a read-only vector, whose pages cannot be written;
+        // read through a const reference instead.
+        T *data() {
+            check_writable_();
+            return elements_();
+        }
+
+        const T *data() const noexcept {
+            return elements_();
+        }
+
+        iterator begin() {
+            return data();
+        }
+
+        iterator end() {
+            return data() + size();
+        }
+
+        const_iterator begin() const noexcept {
+            return data();
+        }
+
+        const_iterator end() const noexcept {
+            return data() + size();
+        }
+
+        T &operator[](size_t index) {
+            assert(index < size());
+            return data()[index];
+        }
+
+        const T &operator[](size_t index) const noexcept {
+            assert(index < size());
+            return data()[index];
+        }
+
+        T &at(size_t index) {
+            if (index >= size()) {
+                throw std::out_of_range("Invalid index");
+            }
+            return data()[index];
+        }
+
+        const T &at(size_t index) const {
+            if (index >= size()) {
+                throw std::out_of_range("Invalid index");
+            }
+            return data()[index];
+        }
+
+        size_t size() const noexcept {
+            return mapping_ ? header_()->size : 0;
+        }
+
+        size_t capacity() const noexcept {
+            return mapping_ ? header_()->capacity : 0;
+        }
+
+        bool empty() const noexcept {
+            return size() == 0;
+        }
+
+        bool read_only() const noexcept {
+            return mode_ == open_mode::read_only;
+        }
+
+        void reserve(size_t new_capacity) {
+            check_writable_();
+            if (new_capacity <= capacity()) {
+                return;
+            }
+            const size_t file_size = data_offset + new_capacity * sizeof(T);
+            resize_file_(file_size);
+            void *moved = ::mremap(mapping_, mapping_size_, file_size, MREMAP_MAYMOVE);
+            if (moved == MAP_FAILED) {
+                throw_errno_("mremap");
+            }
+            mapping_ = moved;
+            mapping_size_ = file_size;
+            header_()->capacity = new_capacity;
+        }
+
+        void resize(size_t new_size) {
+            check_writable_();
+            reserve(new_size);
+            if (new_size > size()) {
+                std::uninitialized_value_construct_n(elements_() + size(), new_size - size());
+            }
+            header_()->size = new_size;
+        }
+
+        template<typename ... Args>
+        T &emplace_back(Args &&... args) {
+            check_writable_();
+            if (size() == capacity()) {
+                // Growing may move the mapping, so the value is built before any argument can dangle.
+                T tmp(std::forward<Args>(args) ...);
+                reserve(GrowthPolicy::next_capacity(capacity(), size() + 1, sizeof(T)));
+                T *slot = new(elements_() + size()) T(tmp);
+                ++header_()->size;
+                return *slot;
+            }
+            T *slot = new(elements_() + size()) T(std::forward<Args>(args) ...);
+            ++header_()->size;
+            return *slot;
+        }
+
+        void push_back(const T &value) {
+            emplace_back(value);
+        }
+
+        void pop_back() {
+            check_writable_();
+            assert(size() != 0);
+            --header_()->size;
+        }
+
+        void clear() {
+            check_writable_();
+            header_()->size = 0;
+        }
+
+        void flush() {
+            if (!read_only() && ::msync(mapping_, mapping_size_, MS_SYNC) != 0) {
+                throw_errno_("msync");
+            }
+        }
+
+    private:
+        mapped_header *header_() const noexcept {
+            return static_cast<mapped_header *>(mapping_);
+        }
+
+        T *elements_() const noexcept {
+            return mapping_ ? reinterpret_cast<T *>(static_cast<std::byte *>(mapping_) + data_offset) : nullptr;
+        }
+
+        void validate_(const std::string &path) const {
+            const mapped_header &header = *header_();
+            if (header.magic != mapped_header::magic_value) {
+                throw std::runtime_error(path + ": not a mapped_vector file");
+            }
+            if (header.version != mapped_header::current_version) {
+                throw std::runtime_error(path + ": unsupported mapped_vector version " +
+                                         std::to_string(header.version));
+            }
+            if (header.type_size != sizeof(T) || header.type_alignment != alignof(T) ||
+                header.data_offset != data_offset) {
+                throw std::runtime_error(path + ": element type does not match the stored layout");
+            }
+            if (header.size > header.capacity || data_offset + header.capacity * sizeof(T) > mapping_size_) {
+                throw std::runtime_error(path + ": header does not match the file size");
+            }
+        }
+
+        void map_(size_t size) {
+            const int prot = read_only() ? PROT_READ : (PROT_READ | PROT_WRITE);
+            void *mapping = ::mmap(nullptr, size, prot, MAP_SHARED, fd_, 0);
+            if (mapping == MAP_FAILED) {
+                throw_errno_("mmap");
+            }
+            mapping_ = mapping;
+            mapping_size_ = size;
+        }
+
+        void resize_file_(size_t size) {
+            if (::ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+                throw_errno_("ftruncate");
+            }
+        }
+
+        void check_writable_() const {
+            if (read_only()) {
+                throw std::logic_error("mapped_vector is opened read-only");
+            }
+        }
+
+        void release_() noexcept {
+            if (mapping_) {
+                ::munmap(mapping_, mapping_size_);
+                mapping_ = nullptr;
+            }
+            if (fd_ >= 0) {
+                ::close(fd_);
+                fd_ = -1;
+            }
+        }
+
+        [[noreturn]] static void throw_errno_(const std::string &what) {
+            throw std::system_error(errno, std::generic_category(), what);
+        }
+
+        int fd_ = -1;
+        void *mapping_ = nullptr;
+        size_t mapping_size_ = 0;
+        open_mode mode_;
+    };
+}
@@ -0,0 +1,326 @@
+#pragma once
+
+#include "bmstu_vector.h"
+
+namespace bmstu {
+    template<typename T, size_t N, typename Allocator = std::allocator<T>, typename GrowthPolicy = grow_2x>
+    class small_vector {
+        static_assert(N != 0, "small_vector needs room for at least one inline element");
+
+        using alloc_traits = std::allocator_traits<Allocator>;
+        using memory_type = raw_memory<T, Allocator>;
+
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+        using growth_policy = GrowthPolicy;
+        using size_type = size_t;
+        using iterator = typename vector<T, Allocator, GrowthPolicy>::iterator;
+        using const_iterator = const iterator;
+
+        static constexpr size_t inline_capacity = N;
+
+        small_vector() = default;
+
+        explicit small_vector(const Allocator &alloc) noexcept : heap_(alloc) {}
+
+        explicit small_vector(size_t size, const Allocator &alloc = Allocator()) : heap_(alloc) {
+            reserve(size);
+            value_construct_n_(data(), size);
+            size_ = size;
+        }
+
+        small_vector(std::initializer_list<T> ilist, const Allocator &alloc = Allocator()) : heap_(alloc) {
+            reserve(ilist.size());
+            std::uninitialized_copy(ilist.begin(), ilist.end(), data());
+            size_ = ilist.size();
+        }
+
+        small_vector(const small_vector &other) : heap_(alloc_traits::select_on_container_copy_construction(
+                other.get_allocator())) {
+            reserve(other.size_);
+            std::uninitialized_copy_n(other.data(), other.size_, data());
+            size_ = other.size_;
+        }
+
+        small_vector(small_vector &&other) noexcept(is_nothrow_relocatable_v<T>) : heap_(other.get_allocator()) {
+            take_(other);
+        }
+
+        small_vector &operator=(const small_vector &other) {
+            if (this != &other) {
+                small_vector copy(other);
+                swap(copy);
+            }
+            return *this;
+        }
+
+        small_vector &operator=(small_vector &&other) noexcept(
+                is_nothrow_relocatable_v<T> && (alloc_traits::propagate_on_container_move_assignment::value ||
+                                                alloc_traits::is_always_equal::value)) {
+            if (this != &other) {
+                clear();
+                if constexpr (alloc_traits::propagate_on_container_move_assignment::value ||
+                              alloc_traits::is_always_equal::value) {
+                    take_(other);
+                } else if (other.is_inline() || get_allocator() == other.get_allocator()) {
+                    take_(other);
+                } else {
+                    reserve(other.size_);
+                    uninitialized_relocate_n(other.data(), other.size_, data());
+                    size_ = std::exchange(other.size_, 0);
+                }
+            }
+            return *this;
+        }
+
+        ~small_vector() {
+            instrumentation::on_release<T>(size_, is_inline() ? 0 : heap_.capacity());
+            std::destroy_n(data(), size_);
+        }
+
+        allocator_type get_allocator() const noexcept {
+            return heap_.get_allocator();
+        }
+
+        bool is_inline() const noexcept {
+            return heap_.get_address() == nullptr;
+        }
+
+        T *data() noexcept {
+            return is_inline() ? std::launder(reinterpret_cast<T *>(inline_)) : heap_.get_address();
+        }
+
+        const T *data() const noexcept {
+            return const_cast<small_vector &>(*this).data();
+        }
+
+        iterator begin() {
+            return data();
+        }
+
+        iterator end() {
+            return data() + size_;
+        }
+
+        const_iterator begin() const {
+            return const_cast<T *>(data());
+        }
+
+        const_iterator end() const {
+            return const_cast<T *>(data()) + size_;
+        }
+
+        const_iterator cbegin() const {
+            return begin();
+        }
+
+        const_iterator cend() const {
+            return end();
+        }
+
+        T &operator[](size_t index) noexcept {
+            assert(index < size_);
+            return data()[index];
+        }
+
+        const T &operator[](size_t index) const noexcept {
+            assert(index < size_);
+            return data()[index];
+        }
+
+        T &at(size_t index) {
+            if (index >= size_) {
+                throw std::out_of_range("Invalid index");
+            }
+            return data()[index];
+        }
+
+        const T &at(size_t index) const {
+            if (index >= size_) {
+                throw std::out_of_range("Invalid index");
+            }
+            return data()[index];
+        }
+
+        void clear() noexcept {
+            std::destroy_n(data(), size_);
+            size_ = 0;
+        }
+
+        void swap(small_vector &other) {
+            small_vector tmp(std::move(other));
+            other = std::move(*this);
+            *this = std::move(tmp);
+        }
+
+        friend void swap(small_vector &left, small_vector &right) {
+            left.swap(right);
+        }
+
+        void reserve(size_t new_capacity) {
+            if (new_capacity > capacity()) {
+                instrumentation::on_reallocation<T>();
+                memory_type new_heap(new_capacity, heap_.get_allocator());
+                uninitialized_relocate_n(data(), size_, new_heap.get_address());
+                heap_.swap(new_heap);
+            }
+        }
+
+        void resize(size_t new_size) {
+            if (new_size < size_) {
+                std::destroy_n(data() + new_size, size_ - new_size);
+            } else if (new_size > size_) {
+                if (new_size > capacity()) {
+                    reserve(next_capacity_(new_size));
+                }
+                value_construct_n_(data() + size_, new_size - size_);
+            }
+            size_ = new_size;
+        }
+
+        void pop_back() noexcept {
+            assert(size_ != 0);
+            --size_;
+            std::destroy_at(data() + size_);
+        }
+
+        template<typename ... Args>
+        T &emplace_back(Args &&... args) {
+            if (size_ == capacity()) {
+                instrumentation::on_reallocation<T>();
+                memory_type new_heap(next_capacity_(size_ + 1), heap_.get_allocator());
+                new(new_heap.get_address() + size_) T(std::forward<Args>(args) ...);
+                try {
+                    uninitialized_relocate_n(data(), size_, new_heap.get_address());
+                } catch (...) {
+                    std::destroy_at(new_heap.get_address() + size_);
+                    throw;
+                }
+                heap_.swap(new_heap);
+            } else {
+                new(data() + size_) T(std::forward<Args>(args) ...);
+            }
+            ++size_;
+            return data()[size_ - 1];
+        }
+
+        template<typename ... Args>
+        iterator emplace(const_iterator pos, Args &&... args) {
+            const size_t index = pos - begin();
+            if (index == size_) {
+                return &emplace_back(std::forward<Args>(args) ...);
+            }
+            T tmp(std::forward<Args>(args) ...);
+            if (size_ == capacity()) {
+                reserve(next_capacity_(size_ + 1));
+            }
+            T *first = data() + index;
+            if constexpr (is_trivially_relocatable_v<T> && std::is_nothrow_move_constructible_v<T>) {
+                trivially_relocate_n(first, size_ - index, first + 1);
+                new(first) T(std::move(tmp));
+            } else {
+                new(data() + size_) T(std::move(data()[size_ - 1]));
+                std::move_backward(first, data() + size_ - 1, data() + size_);
+                *first = std::move(tmp);
+            }
+            ++size_;
+            return first;
+        }
+
+        iterator erase(const_iterator pos) {
+            T *first = data() + (pos - begin());
+            if constexpr (is_trivially_relocatable_v<T>) {
+                std::destroy_at(first);
+                trivially_relocate_n(first + 1, data() + size_ - first - 1, first);
+            } else {
+                std::move(first + 1, data() + size_, first);
+                std::destroy_at(data() + size_ - 1);
+            }
+            --size_;
+            return first;
+        }
+
+        template<typename Type>
+        iterator incert(const_iterator pos, Type &&value) {
+            return emplace(pos, std::forward<Type>(value));
+        }
+
+        template<typename Type>
+        void push_back(Type &&value) {
+            emplace_back(std::forward<Type>(value));
+        }
+
+        size_t size() const noexcept {
+            return size_;
+        }
+
+        size_t capacity() const noexcept {
+            return is_inline() ? N : heap_.capacity();
+        }
+
+        bool empty() const noexcept {
+            return (size_ == 0);
+        }
+
+        friend bool operator==(const small_vector &l, const small_vector &r) {
+            return std::equal(l.data(), l.data() + l.size_, r.data(), r.data() + r.size_);
+        }
+
+        friend bool operator!=(const small_vector &l, const small_vector &r) {
+            return !(l == r);
+        }
+
+        friend bool operator<(const small_vector &l, const small_vector &r) {
+            return std::lexicographical_compare(l.data(), l.data() + l.size_, r.data(), r.data() + r.size_);
+        }
+
+        friend bool operator>(const small_vector &l, const small_vector &r) {
+            return (r < l);
+        }
+
+        friend bool operator<=(const small_vector &l, const small_vector &r) {
+            return !(r < l);
+        }
+
+        friend bool operator>=(const small_vector &l, const small_vector &r) {
+            return !(l < r);
+        }
+
+        template<class S>
+        friend S &operator<<(S &os, const small_vector &other) {
+            os << "[";
+            for (size_t i = 0; i != other.size_; ++i) {
+                os << (i == 0 ? "" : ", ") << other[i];
+            }
+            os << "]";
+            return os;
+        }
+
+    private:
+        size_t next_capacity_(size_t required) const noexcept {
+            return GrowthPolicy::next_capacity(capacity(), required, sizeof(T));
+        }
+
+        static void value_construct_n_(T *first, size_t n) {
+            if constexpr (std::is_default_constructible_v<T>) {
+                std::uninitialized_value_construct_n(first, n);
+            } else {
+                std::fill_n(reinterpret_cast<uint8_t *>(static_cast<void *>(first)), n * sizeof(T), 0);
+            }
+        }
+
+        void take_(small_vector &other) {
+            if (other.is_inline()) {
+                uninitialized_relocate_n(other.data(), other.size_, data());
+            } else {
+                heap_ = std::move(other.heap_);
+            }
+            size_ = std::exchange(other.size_, 0);
+        }
+
+        alignas(T) std::byte inline_[N * sizeof(T)];
+        memory_type heap_;
+        size_t size_ = 0;
+    };
+}
@@ -0,0 +1,362 @@
+#pragma once
+
+#include "growth_policy.h"
+#include "indexed_iterator.h"
+#include "raw_memory.h"
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace bmstu {
+    // Structure-of-arrays vector. Field I of every row lives in column I, a buffer of its own, and all
+    // columns share one size and grow together. column<I>() is a contiguous span, so a scan over one field
+    // reads only that field's bytes. Rows are read and written through tuples of references.
+    template<typename ... Ts>
+    class soa_vector {
+        static_assert(sizeof...(Ts) != 0, "soa_vector needs at least one column");
+
+        using columns_type = std::tuple<raw_memory<Ts>...>;
+
+    public:
+        using value_type = std::tuple<Ts...>;
+        using reference = std::tuple<Ts &...>;
+        using const_reference = std::tuple<const Ts &...>;
+        using size_type = size_t;
+        using iterator = indexed_iterator<soa_vector, value_type, reference>;
+        using const_iterator = indexed_iterator<soa_vector, const value_type, const_reference>;
+
+        template<size_t I>
+        using column_type = std::tuple_element_t<I, value_type>;
+
+        static constexpr size_t column_count = sizeof...(Ts);
+        static constexpr size_t row_size = (sizeof(Ts) + ...);
+
+        soa_vector() = default;
+
+        explicit soa_vector(size_t size) {
+            resize(size);
+        }
+
+        soa_vector(std::initializer_list<value_type> ilist) {
+            reserve(ilist.size());
+            for (const value_type &row: ilist) {
+                push_back(row);
+            }
+        }
+
+        soa_vector(const soa_vector &other) : columns_(allocate_(other.size_)) {
+            construct_rows_(other.columns_, other.size_, columns_);
+            size_ = other.size_;
+        }
+
+        soa_vector(soa_vector &&other) noexcept : columns_(std::move(other.columns_)),
+                                                  size_(std::exchange(other.size_, 0)) {}
+
+        soa_vector &operator=(const soa_vector &other) {
+            if (this != &other) {
+                soa_vector copy(other);
+                swap(copy);
+            }
+            return *this;
+        }
+
+        soa_vector &operator=(soa_vector &&other) noexcept {
+            if (this != &other) {
+                soa_vector tmp(std::move(other));
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        ~soa_vector() {
+            destroy_rows_(columns_, 0, size_);
+        }
+
+        iterator begin() noexcept {
+            return {this, 0};
+        }
+
+        iterator end() noexcept {
+            return {this, size_};
+        }
+
+        const_iterator begin() const noexcept {
+            return {this, 0};
+        }
+
+        const_iterator end() const noexcept {
+            return {this, size_};
+        }
+
+        const_iterator cbegin() const noexcept {
+            return begin();
+        }
+
+        const_iterator cend() const noexcept {
+            return end();
+        }
+
+        reference operator[](size_t index) noexcept {
+            assert(index < size_);
+            return std::apply([index](auto &... column) { return reference(column[index]...); }, columns_);
+        }
+
+        const_reference operator[](size_t index) const noexcept {
+            assert(index < size_);
+            return std::apply([index](const auto &... column) { return const_reference(column[index]...); },
+                              columns_);
+        }
+
+        reference at(size_t index) {
+            if (index >= size_) {
+                throw std::out_of_range("Invalid index");
+            }
+            return (*this)[index];
+        }
+
+        const_reference at(size_t index) const {
+            if (index >= size_) {
+                throw std::out_of_range("Invalid index");
+            }
+            return (*this)[index];
+        }
+
+        template<size_t I>
+        std::span<column_type<I>> column() noexcept {
+            return {std::get<I>(columns_).get_address(), size_};
+        }
+
+        template<size_t I>
+        std::span<const column_type<I>> column() const noexcept {
+            return {std::get<I>(columns_).get_address(), size_};
+        }
+
+        void clear() noexcept {
+            destroy_rows_(columns_, 0, size_);
+            size_ = 0;
+        }
+
+        void swap(soa_vector &other) noexcept {
+            columns_.swap(other.columns_);
+            std::swap(size_, other.size_);
+        }
+
+        friend void swap(soa_vector &left, soa_vector &right) noexcept {
+            left.swap(right);
+        }
+
+        void reserve(size_t new_capacity) {
+            if (new_capacity > capacity()) {
+                change_capacity_(new_capacity);
+            }
+        }
+
+        void shrink_to_fit() {
+            if (size_ < capacity()) {
+                change_capacity_(size_);
+            }
+        }
+
+        void resize(size_t new_size) {
+            if (new_size < size_) {
+                destroy_rows_(columns_, new_size, size_);
+                size_ = new_size;
+                return;
+            }
+            reserve(new_size);
+            size_t done = 0;
+            try {
+                for_each_column_([&](auto i) {
+                    std::uninitialized_value_construct_n(std::get<i>(columns_).get_address() + size_,
+                                                         new_size - size_);
+                    ++done;
+                });
+            } catch (...) {
+                for_each_column_([&](auto i) {
+                    if (i < done) {
+                        std::destroy_n(std::get<i>(columns_).get_address() + size_, new_size - size_);
+                    }
+                });
+                throw;
+            }
+            size_ = new_size;
+        }
+
+        void pop_back() noexcept {
+            assert(size_ != 0);
+            --size_;
+            destroy_rows_(columns_, size_, size_ + 1);
+        }
+
+        // One argument per column; each column's element is constructed from its argument.
+        template<typename ... Args>
+        requires (sizeof...(Args) == sizeof...(Ts))
+        reference emplace_back(Args &&... args) {
+            return emplace_row_(std::forward_as_tuple(std::forward<Args>(args) ...));
+        }
+
+        void push_back(const value_type &row) {
+            emplace_row_(row);
+        }
+
+        void push_back(value_type &&row) {
+            emplace_row_(std::move(row));
+        }
+
+        iterator erase(const_iterator pos) {
+            return erase(pos, pos + 1);
+        }
+
+        iterator erase(const_iterator first, const_iterator last) {
+            const size_t index = first.index();
+            const size_t count = last - first;
+            if (count != 0) {
+                for_each_column_([&](auto i) {
+                    auto *data = std::get<i>(columns_).get_address();
+                    std::move(data + index + count, data + size_, data + index);
+                });
+                destroy_rows_(columns_, size_ - count, size_);
+                size_ -= count;
+            }
+            return {this, index};
+        }
+
+        size_t size() const noexcept {
+            return size_;
+        }
+
+        size_t capacity() const noexcept {
+            return std::get<0>(columns_).capacity();
+        }
+
+        bool empty() const noexcept {
+            return (size_ == 0);
+        }
+
+        friend bool operator==(const soa_vector &l, const soa_vector &r) {
+            if (l.size_ != r.size_) {
+                return false;
+            }
+            bool equal = true;
+            for_each_column_([&](auto i) {
+                const auto *left = std::get<i>(l.columns_).get_address();
+                equal = equal && std::equal(left, left + l.size_, std::get<i>(r.columns_).get_address());
+            });
+            return equal;
+        }
+
+        friend bool operator!=(const soa_vector &l, const soa_vector &r) {
+            return !(l == r);
+        }
+
+    private:
+        template<typename F>
+        static void for_each_column_(F &&f) {
+            [&]<size_t ... I>(std::index_sequence<I...>) {
+                (f(std::integral_constant<size_t, I>{}), ...);
+            }(std::index_sequence_for<Ts...>{});
+        }
+
+        static columns_type allocate_(size_t capacity) {
+            return columns_type(raw_memory<Ts>(capacity) ...);
+        }
+
+        static void destroy_rows_(columns_type &columns, size_t first, size_t last) noexcept {
+            for_each_column_([&](auto i) {
+                std::destroy(std::get<i>(columns).get_address() + first, std::get<i>(columns).get_address() + last);
+            });
+        }
+
+        // Builds rows [0, n) of to from the same rows of from, copying unless From is non-const and the
+        // column cannot be copied. If a constructor throws, the columns already built are destroyed.
+        template<typename From>
+        static void construct_rows_(From &from, size_t n, columns_type &to) {
+            size_t done = 0;
+            try {
+                for_each_column_([&](auto i) {
+                    auto *src = std::get<i>(from).get_address();
+                    auto *dst = std::get<i>(to).get_address();
+                    if constexpr (!std::is_const_v<From> && !std::is_copy_constructible_v<column_type<i>>) {
+                        std::uninitialized_move_n(src, n, dst);
+                    } else {
+                        std::uninitialized_copy_n(src, n, dst);
+                    }
+                    ++done;
+                });
+            } catch (...) {
+                for_each_column_([&](auto i) {
+                    if (i < done) {
+                        std::destroy_n(std::get<i>(to).get_address(), n);
+                    }
+                });
+                throw;
+            }
+        }
+
+        template<typename Row>
+        static void construct_row_(columns_type &columns, size_t index, Row &&row) {
+            size_t done = 0;
+            try {
+                for_each_column_([&](auto i) {
+                    std::construct_at(std::get<i>(columns).get_address() + index, std::get<i>(std::forward<Row>(row)));
+                    ++done;
+                });
+            } catch (...) {
+                for_each_column_([&](auto i) {
+                    if (i < done) {
+                        std::destroy_at(std::get<i>(columns).get_address() + index);
+                    }
+                });
+                throw;
+            }
+        }
+
+        // Moves every row into to with memcpy or a nothrow move when all columns allow it. Otherwise the rows
+        // are copied first and the originals destroyed only once every column has been copied, so a
+        // throwing copy leaves the vector unchanged.
+        void transfer_rows_(columns_type &to) {
+            if constexpr ((is_nothrow_relocatable_v<Ts> && ...)) {
+                for_each_column_([&](auto i) {
+                    uninitialized_relocate_n(std::get<i>(columns_).get_address(), size_, std::get<i>(to).get_address());
+                });
+            } else {
+                construct_rows_(columns_, size_, to);
+                destroy_rows_(columns_, 0, size_);
+            }
+        }
+
+        void change_capacity_(size_t capacity) {
+            columns_type new_columns = allocate_(capacity);
+            transfer_rows_(new_columns);
+            columns_.swap(new_columns);
+        }
+
+        // The new row is built in the new columns before the old rows move, so it may refer to one of them.
+        template<typename Row>
+        reference emplace_row_(Row &&row) {
+            if (size_ == capacity()) {
+                columns_type new_columns = allocate_(grow_2x::next_capacity(capacity(), size_ + 1, row_size));
+                construct_row_(new_columns, size_, std::forward<Row>(row));
+                try {
+                    transfer_rows_(new_columns);
+                } catch (...) {
+                    destroy_rows_(new_columns, size_, size_ + 1);
+                    throw;
+                }
+                columns_.swap(new_columns);
+            } else {
+                construct_row_(columns_, size_, std::forward<Row>(row));
+            }
+            ++size_;
+            return (*this)[size_ - 1];
+        }
+
+        columns_type columns_;
+        size_t size_ = 0;
+    };
+}
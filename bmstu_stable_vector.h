@@ -0,0 +1,368 @@
+#pragma once
+
+#include "bmstu_vector.h"
+#include "indexed_iterator.h"
+#include <bit>
+#include <cassert>
+#include <iterator>
+#include <memory>
+
+namespace bmstu {
+    template<typename T>
+    inline constexpr size_t default_chunk_size = std::bit_floor(std::max<size_t>(1, 4096 / sizeof(T)));
+
+    // Vector whose elements live in fixed-size chunks reached through a chunk table, so growth only ever
+    // appends a chunk and never moves existing elements. Pointers and references stay valid until the
+    // element is erased or the container shrinks past it. Chunks left empty at the end are kept on a free
+    // list and reused before anything new is allocated.
+    template<typename T, size_t ChunkSize = default_chunk_size<T>, typename Allocator = std::allocator<T>>
+    class stable_vector {
+        static_assert(std::has_single_bit(ChunkSize), "ChunkSize must be a power of two");
+
+        using alloc_traits = std::allocator_traits<Allocator>;
+        using memory_type = raw_memory<T, Allocator>;
+        using table_type = vector<memory_type, typename alloc_traits::template rebind_alloc<memory_type>>;
+
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+        using size_type = size_t;
+        using iterator = indexed_iterator<stable_vector, T>;
+        using const_iterator = indexed_iterator<stable_vector, const T>;
+
+        static constexpr size_t chunk_size = ChunkSize;
+
+        stable_vector() = default;
+
+        explicit stable_vector(const Allocator &alloc) noexcept : alloc_(alloc) {}
+
+        explicit stable_vector(size_t size, const Allocator &alloc = Allocator()) : alloc_(alloc) {
+            resize(size);
+        }
+
+        stable_vector(std::initializer_list<T> ilist, const Allocator &alloc = Allocator()) : alloc_(alloc) {
+            reserve(ilist.size());
+            for (const T &value: ilist) {
+                emplace_back(value);
+            }
+        }
+
+        template<std::input_iterator It>
+        stable_vector(It first, It last, const Allocator &alloc = Allocator()) : alloc_(alloc) {
+            if constexpr (std::forward_iterator<It>) {
+                reserve(static_cast<size_t>(std::distance(first, last)));
+            }
+            for (; first != last; ++first) {
+                emplace_back(*first);
+            }
+        }
+
+        stable_vector(const stable_vector &other) : stable_vector(other.begin(), other.end(),
+                                                                  alloc_traits::select_on_container_copy_construction(
+                                                                          other.alloc_)) {}
+
+        stable_vector(stable_vector &&other) noexcept : alloc_(other.alloc_),
+                                                        chunks_(std::move(other.chunks_)),
+                                                        free_chunks_(std::move(other.free_chunks_)),
+                                                        size_(std::exchange(other.size_, 0)) {}
+
+        stable_vector &operator=(const stable_vector &other) {
+            if (this != &other) {
+                if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+                    if (alloc_ != other.alloc_) {
+                        stable_vector copy(other.begin(), other.end(), other.alloc_);
+                        adopt_(copy);
+                        return *this;
+                    }
+                }
+                stable_vector copy(other.begin(), other.end(), alloc_);
+                swap(copy);
+            }
+            return *this;
+        }
+
+        stable_vector &operator=(stable_vector &&other) noexcept(
+                alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value) {
+            if (this != &other) {
+                if constexpr (alloc_traits::propagate_on_container_move_assignment::value ||
+                              alloc_traits::is_always_equal::value) {
+                    adopt_(other);
+                } else if (alloc_ == other.alloc_) {
+                    adopt_(other);
+                } else {
+                    stable_vector copy(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()),
+                                       alloc_);
+                    swap(copy);
+                    other.clear();
+                }
+            }
+            return *this;
+        }
+
+        ~stable_vector() {
+            instrumentation::on_release<T>(size_, capacity());
+            destroy_from_(0);
+        }
+
+        allocator_type get_allocator() const noexcept {
+            return alloc_;
+        }
+
+        iterator begin() noexcept {
+            return {this, 0};
+        }
+
+        iterator end() noexcept {
+            return {this, size_};
+        }
+
+        const_iterator begin() const noexcept {
+            return {this, 0};
+        }
+
+        const_iterator end() const noexcept {
+            return {this, size_};
+        }
+
+        const_iterator cbegin() const noexcept {
+            return begin();
+        }
+
+        const_iterator cend() const noexcept {
+            return end();
+        }
+
+        T &operator[](size_t index) noexcept {
+            assert(index < size_);
+            return chunks_[index / ChunkSize].get_address()[index % ChunkSize];
+        }
+
+        const T &operator[](size_t index) const noexcept {
+            assert(index < size_);
+            return chunks_[index / ChunkSize].get_address()[index % ChunkSize];
+        }
+
+        T &at(size_t index) {
+            if (index >= size_) {
+                throw std::out_of_range("Invalid index");
+            }
+            return (*this)[index];
+        }
+
+        const T &at(size_t index) const {
+            if (index >= size_) {
+                throw std::out_of_range("Invalid index");
+            }
+            return (*this)[index];
+        }
+
+        void clear() noexcept {
+            destroy_from_(0);
+            recycle_chunks_();
+        }
+
+        void swap(stable_vector &other) noexcept {
+            if constexpr (alloc_traits::propagate_on_container_swap::value) {
+                using std::swap;
+                swap(alloc_, other.alloc_);
+            } else {
+                assert(alloc_ == other.alloc_);
+            }
+            chunks_.swap(other.chunks_);
+            free_chunks_.swap(other.free_chunks_);
+            std::swap(size_, other.size_);
+        }
+
+        friend void swap(stable_vector &left, stable_vector &right) noexcept {
+            left.swap(right);
+        }
+
+        void reserve(size_t new_capacity) {
+            while (capacity() < new_capacity) {
+                add_chunk_();
+            }
+        }
+
+        // Frees the recycled chunks and every chunk past the last element.
+        void shrink_to_fit() {
+            recycle_chunks_();
+            free_chunks_.clear();
+            free_chunks_.shrink_to(chunks_.size());
+            chunks_.shrink_to_fit();
+        }
+
+        size_t memory_usage() const noexcept {
+            return (chunks_.size() + free_chunks_.size()) * ChunkSize * sizeof(T) +
+                   (chunks_.capacity() + free_chunks_.capacity()) * sizeof(memory_type);
+        }
+
+        void resize(size_t new_size) {
+            if (new_size < size_) {
+                destroy_from_(new_size);
+                recycle_chunks_();
+                return;
+            }
+            reserve(new_size);
+            while (size_ < new_size) {
+                const size_t run = std::min(new_size - size_, ChunkSize - size_ % ChunkSize);
+                T *first = &slot_(size_);
+                if constexpr (std::is_default_constructible_v<T>) {
+                    std::uninitialized_value_construct_n(first, run);
+                } else {
+                    std::fill_n(reinterpret_cast<uint8_t *>(static_cast<void *>(first)), run * sizeof(T), 0);
+                }
+                size_ += run;
+            }
+        }
+
+        void pop_back() noexcept {
+            assert(size_ != 0);
+            --size_;
+            std::destroy_at(&slot_(size_));
+            recycle_chunks_();
+        }
+
+        template<typename ... Args>
+        T &emplace_back(Args &&... args) {
+            if (size_ == capacity()) {
+                add_chunk_();
+            }
+            T *value = new(&slot_(size_)) T(std::forward<Args>(args) ...);
+            ++size_;
+            return *value;
+        }
+
+        // Elements after pos shift by one; nothing else moves.
+        template<typename ... Args>
+        iterator emplace(const_iterator pos, Args &&... args) {
+            const size_t index = pos.index();
+            if (index == size_) {
+                emplace_back(std::forward<Args>(args) ...);
+                return {this, index};
+            }
+            T tmp(std::forward<Args>(args) ...);
+            emplace_back(std::move((*this)[size_ - 1]));
+            std::move_backward(begin() + index, end() - 2, end() - 1);
+            (*this)[index] = std::move(tmp);
+            return {this, index};
+        }
+
+        iterator erase(const_iterator pos) {
+            return erase(pos, pos + 1);
+        }
+
+        iterator erase(const_iterator first, const_iterator last) {
+            const size_t index = first.index();
+            if (first != last) {
+                std::move(begin() + last.index(), end(), begin() + index);
+                destroy_from_(size_ - (last - first));
+                recycle_chunks_();
+            }
+            return {this, index};
+        }
+
+        template<typename Type>
+        iterator incert(const_iterator pos, Type &&value) {
+            return emplace(pos, std::forward<Type>(value));
+        }
+
+        template<typename Type>
+        void push_back(Type &&value) {
+            emplace_back(std::forward<Type>(value));
+        }
+
+        size_t size() const noexcept {
+            return size_;
+        }
+
+        size_t capacity() const noexcept {
+            return chunks_.size() * ChunkSize;
+        }
+
+        bool empty() const noexcept {
+            return (size_ == 0);
+        }
+
+        friend bool operator==(const stable_vector &l, const stable_vector &r) {
+            return std::equal(l.begin(), l.end(), r.begin(), r.end());
+        }
+
+        friend bool operator!=(const stable_vector &l, const stable_vector &r) {
+            return !(l == r);
+        }
+
+        friend bool operator<(const stable_vector &l, const stable_vector &r) {
+            return std::lexicographical_compare(l.begin(), l.end(), r.begin(), r.end());
+        }
+
+        friend bool operator>(const stable_vector &l, const stable_vector &r) {
+            return (r < l);
+        }
+
+        friend bool operator<=(const stable_vector &l, const stable_vector &r) {
+            return !(r < l);
+        }
+
+        friend bool operator>=(const stable_vector &l, const stable_vector &r) {
+            return !(l < r);
+        }
+
+        template<class S>
+        friend S &operator<<(S &os, const stable_vector &other) {
+            os << "[";
+            for (size_t i = 0; i != other.size_; ++i) {
+                os << (i == 0 ? "" : ", ") << other[i];
+            }
+            os << "]";
+            return os;
+        }
+
+    private:
+        T &slot_(size_t index) noexcept {
+            return chunks_[index / ChunkSize].get_address()[index % ChunkSize];
+        }
+
+        // Replaces *this with other's elements, chunks and allocator, which assignment may only do when the
+        // allocators are equal or propagate. Going through the move constructor avoids assigning alloc_, which
+        // allocators such as polymorphic_allocator do not support.
+        void adopt_(stable_vector &other) noexcept {
+            std::destroy_at(this);
+            std::construct_at(this, std::move(other));
+        }
+
+        // The free list always has room for every chunk, so recycling never allocates.
+        void add_chunk_() {
+            const size_t total = chunks_.size() + free_chunks_.size() + 1;
+            if (free_chunks_.capacity() < total) {
+                free_chunks_.reserve(std::max(total, 2 * free_chunks_.capacity()));
+            }
+            if (free_chunks_.empty()) {
+                chunks_.emplace_back(ChunkSize, alloc_);
+            } else {
+                chunks_.push_back(std::move(free_chunks_[free_chunks_.size() - 1]));
+                free_chunks_.pop_back();
+            }
+        }
+
+        // Moves chunks that no longer hold any element onto the free list.
+        void recycle_chunks_() noexcept {
+            const size_t used = (size_ + ChunkSize - 1) / ChunkSize;
+            while (chunks_.size() > used) {
+                free_chunks_.push_back(std::move(chunks_[chunks_.size() - 1]));
+                chunks_.pop_back();
+            }
+        }
+
+        void destroy_from_(size_t index) noexcept {
+            for (size_t i = index; i < size_; ++i) {
+                std::destroy_at(&slot_(i));
+            }
+            size_ = index;
+        }
+
+        [[no_unique_address]] Allocator alloc_;
+        table_type chunks_{typename table_type::allocator_type(alloc_)};
+        table_type free_chunks_{typename table_type::allocator_type(alloc_)};
+        size_t size_ = 0;
+    };
+}
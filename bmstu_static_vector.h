@@ -0,0 +1,343 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace bmstu {
+    struct throw_on_overflow {
+        static void overflow() {
+            throw std::length_error("static_vector capacity exceeded");
+        }
+    };
+
+    // Stops the program in release builds too: carrying on would construct past the inline storage.
+    struct assert_on_overflow {
+        [[noreturn]] static void overflow() noexcept {
+            assert(false && "static_vector capacity exceeded");
+            std::abort();
+        }
+    };
+
+    template<typename T, size_t N, typename OverflowPolicy = throw_on_overflow>
+    class static_vector {
+        static constexpr bool trivial_ = std::is_trivial_v<T>;
+
+    public:
+        using value_type = T;
+        using size_type = size_t;
+        using overflow_policy = OverflowPolicy;
+        using iterator = T *;
+        using const_iterator = const T *;
+
+        constexpr static_vector() noexcept = default;
+
+        constexpr explicit static_vector(size_t size) {
+            resize(size);
+        }
+
+        constexpr static_vector(std::initializer_list<T> ilist) {
+            check_capacity_(ilist.size());
+            for (const T &value: ilist) {
+                construct_(size_++, value);
+            }
+        }
+
+        constexpr static_vector(const static_vector &other) {
+            if constexpr (trivial_) {
+                std::copy_n(other.data(), other.size_, data());
+            } else {
+                std::uninitialized_copy_n(other.data(), other.size_, data());
+            }
+            size_ = other.size_;
+        }
+
+        constexpr static_vector(static_vector &&other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+            if constexpr (trivial_) {
+                std::copy_n(other.data(), other.size_, data());
+            } else {
+                std::uninitialized_move_n(other.data(), other.size_, data());
+            }
+            size_ = other.size_;
+            other.clear();
+        }
+
+        constexpr static_vector &operator=(const static_vector &other) {
+            if (this != &other) {
+                assign_(other.data(), other.size_, [](const T &value) -> const T & { return value; });
+            }
+            return *this;
+        }
+
+        constexpr static_vector &operator=(static_vector &&other) noexcept(std::is_nothrow_move_assignable_v<T> &&
+                                                                          std::is_nothrow_move_constructible_v<T>) {
+            if (this != &other) {
+                assign_(other.data(), other.size_, [](T &value) -> T && { return std::move(value); });
+                other.clear();
+            }
+            return *this;
+        }
+
+        constexpr ~static_vector() requires trivial_ = default;
+
+        constexpr ~static_vector() {
+            std::destroy_n(data(), size_);
+        }
+
+        constexpr T *data() noexcept {
+            if constexpr (trivial_) {
+                return storage_.elems;
+            } else {
+                return std::launder(reinterpret_cast<T *>(storage_.bytes));
+            }
+        }
+
+        constexpr const T *data() const noexcept {
+            return const_cast<static_vector &>(*this).data();
+        }
+
+        constexpr iterator begin() noexcept {
+            return data();
+        }
+
+        constexpr iterator end() noexcept {
+            return data() + size_;
+        }
+
+        constexpr const_iterator begin() const noexcept {
+            return data();
+        }
+
+        constexpr const_iterator end() const noexcept {
+            return data() + size_;
+        }
+
+        constexpr const_iterator cbegin() const noexcept {
+            return begin();
+        }
+
+        constexpr const_iterator cend() const noexcept {
+            return end();
+        }
+
+        constexpr T &operator[](size_t index) noexcept {
+            assert(index < size_);
+            return data()[index];
+        }
+
+        constexpr const T &operator[](size_t index) const noexcept {
+            assert(index < size_);
+            return data()[index];
+        }
+
+        constexpr T &at(size_t index) {
+            if (index >= size_) {
+                throw std::out_of_range("Invalid index");
+            }
+            return data()[index];
+        }
+
+        constexpr const T &at(size_t index) const {
+            if (index >= size_) {
+                throw std::out_of_range("Invalid index");
+            }
+            return data()[index];
+        }
+
+        constexpr void clear() noexcept {
+            std::destroy_n(data(), size_);
+            size_ = 0;
+        }
+
+        constexpr void swap(static_vector &other) {
+            static_vector tmp(std::move(other));
+            other = std::move(*this);
+            *this = std::move(tmp);
+        }
+
+        friend constexpr void swap(static_vector &left, static_vector &right) {
+            left.swap(right);
+        }
+
+        constexpr void reserve(size_t new_capacity) {
+            check_capacity_(new_capacity);
+        }
+
+        constexpr void resize(size_t new_size) {
+            if (new_size < size_) {
+                std::destroy_n(data() + new_size, size_ - new_size);
+                size_ = new_size;
+            } else {
+                check_capacity_(new_size);
+                for (; size_ < new_size; ++size_) {
+                    if constexpr (std::is_default_constructible_v<T>) {
+                        construct_(size_);
+                    } else {
+                        std::fill_n(reinterpret_cast<uint8_t *>(static_cast<void *>(data() + size_)), sizeof(T), 0);
+                    }
+                }
+            }
+        }
+
+        constexpr void pop_back() noexcept {
+            assert(size_ != 0);
+            --size_;
+            std::destroy_at(data() + size_);
+        }
+
+        template<typename ... Args>
+        constexpr T &emplace_back(Args &&... args) {
+            check_capacity_(size_ + 1);
+            construct_(size_, std::forward<Args>(args) ...);
+            return data()[size_++];
+        }
+
+        template<typename Type>
+        constexpr bool try_push_back(Type &&value) {
+            if (size_ == N) {
+                return false;
+            }
+            construct_(size_, std::forward<Type>(value));
+            ++size_;
+            return true;
+        }
+
+        template<typename ... Args>
+        constexpr iterator emplace(const_iterator pos, Args &&... args) {
+            const size_t index = pos - begin();
+            if (index == size_) {
+                return &emplace_back(std::forward<Args>(args) ...);
+            }
+            check_capacity_(size_ + 1);
+            T tmp(std::forward<Args>(args) ...);
+            construct_(size_, std::move(data()[size_ - 1]));
+            std::move_backward(data() + index, data() + size_ - 1, data() + size_);
+            data()[index] = std::move(tmp);
+            ++size_;
+            return data() + index;
+        }
+
+        constexpr iterator erase(const_iterator pos) {
+            const size_t index = pos - begin();
+            std::move(data() + index + 1, data() + size_, data() + index);
+            pop_back();
+            return data() + index;
+        }
+
+        template<typename Type>
+        constexpr iterator incert(const_iterator pos, Type &&value) {
+            return emplace(pos, std::forward<Type>(value));
+        }
+
+        template<typename Type>
+        constexpr void push_back(Type &&value) {
+            emplace_back(std::forward<Type>(value));
+        }
+
+        constexpr size_t size() const noexcept {
+            return size_;
+        }
+
+        static constexpr size_t capacity() noexcept {
+            return N;
+        }
+
+        constexpr bool empty() const noexcept {
+            return (size_ == 0);
+        }
+
+        constexpr bool full() const noexcept {
+            return (size_ == N);
+        }
+
+        friend constexpr bool operator==(const static_vector &l, const static_vector &r) {
+            return std::equal(l.begin(), l.end(), r.begin(), r.end());
+        }
+
+        friend constexpr bool operator!=(const static_vector &l, const static_vector &r) {
+            return !(l == r);
+        }
+
+        friend constexpr bool operator<(const static_vector &l, const static_vector &r) {
+            return std::lexicographical_compare(l.begin(), l.end(), r.begin(), r.end());
+        }
+
+        friend constexpr bool operator>(const static_vector &l, const static_vector &r) {
+            return (r < l);
+        }
+
+        friend constexpr bool operator<=(const static_vector &l, const static_vector &r) {
+            return !(r < l);
+        }
+
+        friend constexpr bool operator>=(const static_vector &l, const static_vector &r) {
+            return !(l < r);
+        }
+
+        template<class S>
+        friend S &operator<<(S &os, const static_vector &other) {
+            os << "[";
+            for (size_t i = 0; i != other.size_; ++i) {
+                os << (i == 0 ? "" : ", ") << other[i];
+            }
+            os << "]";
+            return os;
+        }
+
+    private:
+        struct trivial_storage {
+            constexpr trivial_storage() noexcept {
+                if (std::is_constant_evaluated()) {
+                    std::fill_n(elems, N, T{});
+                }
+            }
+
+            T elems[N];
+        };
+
+        struct raw_storage {
+            alignas(T) std::byte bytes[N * sizeof(T)];
+        };
+
+        static constexpr void check_capacity_(size_t required) {
+            if (required > N) {
+                OverflowPolicy::overflow();
+            }
+        }
+
+        template<typename ... Args>
+        constexpr void construct_(size_t index, Args &&... args) {
+            if constexpr (trivial_) {
+                storage_.elems[index] = T(std::forward<Args>(args) ...);
+            } else {
+                new(data() + index) T(std::forward<Args>(args) ...);
+            }
+        }
+
+        template<typename Source, typename Cast>
+        constexpr void assign_(Source *src, size_t n, Cast cast) {
+            const size_t common = std::min(size_, n);
+            for (size_t i = 0; i < common; ++i) {
+                data()[i] = cast(src[i]);
+            }
+            for (size_t i = common; i < n; ++i) {
+                construct_(i, cast(src[i]));
+            }
+            if (n < size_) {
+                std::destroy_n(data() + n, size_ - n);
+            }
+            size_ = n;
+        }
+
+        std::conditional_t<trivial_, trivial_storage, raw_storage> storage_;
+        size_t size_ = 0;
+    };
+}
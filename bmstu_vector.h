@@ -1,23 +1,51 @@
 #pragma once
 
+#include "aligned_allocator.h"
+#include "growth_policy.h"
 #include "raw_memory.h"
+#include "relocation.h"
+#include "simd.h"
 #include <algorithm>
+#include <compare>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory_resource>
+#include <ranges>
+#include <stdexcept>
 #include <type_traits>
 #include <iostream>
 
 
 namespace bmstu {
-    template<typename T>
+    struct default_init_t {
+        explicit default_init_t() = default;
+    };
+
+    inline constexpr default_init_t default_init{};
+
+    template<typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = grow_2x>
     class vector {
+        using alloc_traits = std::allocator_traits<Allocator>;
+        using memory_type = raw_memory<T, Allocator>;
+
     public:
+        using value_type = T;
+        using allocator_type = Allocator;
+        using growth_policy = GrowthPolicy;
+        using size_type = size_t;
 
         struct iterator {
             using iterator_category = std::random_access_iterator_tag;
+            using iterator_concept = std::contiguous_iterator_tag;
             using difference_type = std::ptrdiff_t;
             using value_type = T;
+            using element_type = T;
             using pointer = T *;
             using reference = T &;
 
+            iterator() = default;
+
             iterator(pointer ptr) : m_ptr(ptr) {}
 
 
@@ -25,10 +53,14 @@ namespace bmstu {
                 return *m_ptr;
             }
 
-            pointer operator->() {
+            pointer operator->() const {
                 return m_ptr;
             }
 
+            reference operator[](difference_type n) const {
+                return m_ptr[n];
+            }
+
             iterator &operator++() {
                 ++m_ptr;
                 return *this;
@@ -39,11 +71,6 @@ namespace bmstu {
                 return *this;
             }
 
-            iterator &operator=(const iterator &other) {
-                this->m_ptr = other.m_ptr;
-                return *this;
-            }
-
             iterator operator++(int) {
                 iterator tmp = *this;
                 ++(*this);
@@ -56,65 +83,109 @@ namespace bmstu {
                 return tmp;
             }
 
+            iterator &operator+=(difference_type n) noexcept {
+                m_ptr += n;
+                return *this;
+            }
+
+            iterator &operator-=(difference_type n) noexcept {
+                m_ptr -= n;
+                return *this;
+            }
+
             friend bool operator==(const iterator &a, const iterator &b) {
                 return a.m_ptr == b.m_ptr;
             }
 
-            friend bool operator!=(const iterator &a, const iterator &b) {
-                return !(a == b);
+            friend auto operator<=>(const iterator &a, const iterator &b) {
+                return a.m_ptr <=> b.m_ptr;
             }
 
-            friend ptrdiff_t operator-(const iterator &a, const iterator &b) {
+            friend difference_type operator-(const iterator &a, const iterator &b) {
                 return a.m_ptr - b.m_ptr;
             }
 
-            iterator &operator+(size_t n) noexcept {
-                m_ptr = m_ptr + n;
-                return *this;
+            friend iterator operator+(iterator it, difference_type n) noexcept {
+                return it += n;
             }
 
-            iterator &operator-(size_t n) noexcept {
-                m_ptr = m_ptr - n;
-                return *this;
+            friend iterator operator+(difference_type n, iterator it) noexcept {
+                return it += n;
+            }
+
+            friend iterator operator-(iterator it, difference_type n) noexcept {
+                return it -= n;
             }
 
         private:
-            pointer m_ptr;
+            pointer m_ptr = nullptr;
         };
 
         using const_iterator = const iterator;
 
         vector() = default;
 
+        explicit vector(const Allocator &alloc) noexcept : data_(alloc) {}
 
-        explicit vector(size_t size) : data_(size), size_(size) {
-            if constexpr (std::is_default_constructible_v<T>) {
-                std::uninitialized_value_construct_n(data_.get_address(), size);
-            } else {
-                uint8_t *ptr = reinterpret_cast<uint8_t *>(static_cast<void *>(data_.get_address()));
-                std::fill(ptr, ptr + (size * sizeof(T)), 0);
-            }
+        explicit vector(size_t size, const Allocator &alloc = Allocator()) : data_(size, alloc), size_(size) {
+            value_construct_n_(data_.get_address(), size);
         }
 
 
-        vector(std::initializer_list<T> ilist) : data_(ilist.size()), size_(ilist.size()) {
-            std::copy(ilist.begin(), ilist.end(), begin());
+        vector(size_t size, default_init_t, const Allocator &alloc = Allocator()) : data_(size, alloc), size_(size) {
+            default_construct_n_(data_.get_address(), size);
         }
 
+        vector(std::initializer_list<T> ilist, const Allocator &alloc = Allocator()) : data_(ilist.size(), alloc),
+                                                                                       size_(ilist.size()) {
+            std::uninitialized_copy(ilist.begin(), ilist.end(), data_.get_address());
+        }
 
-        vector(const vector &other) : data_(other.size_), size_(other.size_) {
+
+        template<std::input_iterator It>
+        vector(It first, It last, const Allocator &alloc = Allocator()) : data_(alloc) {
+            assign(first, last);
+        }
+
+        vector(const vector &other) : vector(other,
+                                             alloc_traits::select_on_container_copy_construction(
+                                                     other.get_allocator())) {}
+
+        vector(const vector &other, const Allocator &alloc) : data_(other.size_, alloc), size_(other.size_) {
             std::uninitialized_copy_n(other.data_.get_address(), other.size_, data_.get_address());
         }
 
-        vector(vector &&other) noexcept {
-            std::swap(data_, other.data_);
-            std::swap(size_, other.size_);
+        vector(vector &&other) noexcept : data_(std::move(other.data_)), size_(std::exchange(other.size_, 0)) {}
+
+        vector(vector &&other, const Allocator &alloc) noexcept(alloc_traits::is_always_equal::value) : data_(alloc) {
+            if (alloc == other.get_allocator()) {
+                data_.swap(other.data_);
+                size_ = std::exchange(other.size_, 0);
+            } else {
+                memory_type new_data(other.size_, alloc);
+                std::uninitialized_move_n(other.data_.get_address(), other.size_, new_data.get_address());
+                data_.swap(new_data);
+                size_ = other.size_;
+            }
         }
 
-        vector &operator=(const vector &other) noexcept {
-            if (this != other) {
+        // Reuses the existing buffer when it is large enough. Like std::vector this gives the basic guarantee:
+        // if an element copy throws, *this holds valid elements but its contents are unspecified. Use
+        // assign_strong to leave *this unchanged instead.
+        vector &operator=(const vector &other) {
+            if (this != &other) {
+                if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+                    if (get_allocator() != other.get_allocator()) {
+                        vector copy(other, other.get_allocator());
+                        std::destroy_n(data_.get_address(), size_);
+                        size_ = 0;
+                        data_.swap_with_allocator(copy.data_);
+                        size_ = std::exchange(copy.size_, 0);
+                        return *this;
+                    }
+                }
                 if (other.size_ > data_.capacity()) {
-                    vector copy(other);
+                    vector copy(other, get_allocator());
                     swap(copy);
                 } else {
                     if (!(size_ < other.size_)) {
@@ -122,7 +193,7 @@ namespace bmstu {
                         std::destroy_n(data_.get_address() + other.size_, size_ - other.size_);
                         size_ = other.size_;
                     } else {
-                        std::copy_n(other.data_.get_address(), other.size_, data_.get_address());
+                        std::copy_n(other.data_.get_address(), size_, data_.get_address());
                         std::uninitialized_copy_n(other.data_.get_address() + size_, other.size_ - size_,
                                                   data_.get_address() + size_);
                         size_ = other.size_;
@@ -132,21 +203,32 @@ namespace bmstu {
             return *this;
         }
 
-        vector &operator=(vector &&right) {
+        vector &operator=(vector &&right) noexcept(alloc_traits::propagate_on_container_move_assignment::value ||
+                                                   alloc_traits::is_always_equal::value) {
             if (this != &right) {
-                data_ = std::move(right.data_);
-                size_ = right.size_;
-                right.size_ = 0;
+                if constexpr (alloc_traits::propagate_on_container_move_assignment::value ||
+                              alloc_traits::is_always_equal::value) {
+                    steal_(right);
+                } else if (get_allocator() == right.get_allocator()) {
+                    steal_(right);
+                } else {
+                    move_elements_(right);
+                }
             }
             return *this;
         }
 
         ~vector() {
+            instrumentation::on_release<T>(size_, capacity());
             if (size_ != 0) {
                 std::destroy_n(data_.get_address(), size_);
             }
         }
 
+        allocator_type get_allocator() const noexcept {
+            return data_.get_allocator();
+        }
+
         iterator begin() {
             return data_.get_address();
         }
@@ -180,7 +262,7 @@ namespace bmstu {
         }
 
         typename iterator::reference at(size_t index) {
-            if (index > size_) {
+            if (index >= size_) {
                 throw std::out_of_range("Invalid index");
             } else {
                 return data_[index];
@@ -188,70 +270,142 @@ namespace bmstu {
         }
 
         typename const_iterator::reference at(size_t index) const {
-            if (index > size_) {
+            if (index >= size_) {
                 throw std::out_of_range("Invalid index");
             } else {
-                return const_cast <typename const_iterator::value_type>(data_[index]);
+                return const_cast <typename const_iterator::reference>(data_[index]);
             }
 
         }
 
+        // Carries the buffer alignment, so loops over data() need no peeling for an over-aligned allocator.
+        T *data() noexcept {
+            return std::assume_aligned<memory_type::alignment>(data_.get_address());
+        }
+
+        const T *data() const noexcept {
+            return std::assume_aligned<memory_type::alignment>(data_.get_address());
+        }
+
+        iterator find(const T &value) {
+            return data_.get_address() + find_index_(value);
+        }
+
+        const_iterator find(const T &value) const {
+            return data_.get_address() + find_index_(value);
+        }
+
+        bool contains(const T &value) const {
+            return find_index_(value) != size_;
+        }
+
+        size_t count(const T &value) const {
+            if constexpr (simd::has_lane_v<T>) {
+                return simd::count(data_.get_address(), size_, value);
+            } else {
+                return static_cast<size_t>(std::count(data_.get_address(), data_.get_address() + size_, value));
+            }
+        }
+
 
         void clear() noexcept {
+            std::destroy_n(data_.get_address(), size_);
             size_ = 0;
         }
 
-        friend void swap(vector<T> &left, vector<T> &right) {
-            std::swap(left.data_, right.data_);
-            std::swap(left.size_, right.size_);
+        void swap(vector &other) noexcept {
+            data_.swap(other.data_);
+            std::swap(size_, other.size_);
+        }
+
+        friend void swap(vector &left, vector &right) noexcept {
+            left.swap(right);
         }
 
         void reserve(size_t new_capaity) {
             if (new_capaity <= data_.capacity()) {
                 return;
             }
-            raw_memory<T> new_data(new_capaity);
-            if constexpr (std::is_move_constructible_v<T>) {
-                std::uninitialized_move_n(data_.get_address(), size_, new_data.get_address());
-            } else {
-                std::uninitialized_copy_n(data_.get_address(), size_, new_data.get_address());
+            change_capacity_(new_capaity);
+        }
+
+        void shrink_to(size_t new_capacity) {
+            new_capacity = std::max(new_capacity, size_);
+            if (new_capacity < data_.capacity()) {
+                change_capacity_(new_capacity);
             }
-            std::destroy_n(data_.get_address(), size_);
-            data_.swap(new_data);
+        }
+
+        void shrink_to_fit() {
+            shrink_to(size_);
+        }
+
+        bool shrink_if_slack_exceeds(size_t percent) {
+            if ((data_.capacity() - size_) * 100 > data_.capacity() * percent) {
+                shrink_to_fit();
+                return true;
+            }
+            return false;
+        }
+
+        size_t memory_usage() const noexcept {
+            return data_.capacity() * sizeof(T);
         }
 
         void resize(size_t new_size) {
             if (new_size < size_) {
                 std::destroy_n(data_.get_address() + new_size, size_ - new_size);
-                size_ = new_size;
-            } else {
+            } else if (new_size > size_) {
                 if (new_size > capacity()) {
-                    reserve(new_size * 2);
+                    reserve(next_capacity_(new_size));
                 }
-                raw_memory<T> new_data(new_size);
-                std::uninitialized_copy_n(data_.get_address(), size_, new_data.get_address());
-                data_.swap(new_data);
-                size_ = new_size;
+                value_construct_n_(data_.get_address() + size_, new_size - size_);
+            }
+            size_ = new_size;
+        }
+
+        void resize_for_overwrite(size_t new_size) {
+            if (new_size < size_) {
+                std::destroy_n(data_.get_address() + new_size, size_ - new_size);
+            } else if (new_size > size_) {
+                if (new_size > capacity()) {
+                    reserve(next_capacity_(new_size));
+                }
+                default_construct_n_(data_.get_address() + size_, new_size - size_);
             }
+            size_ = new_size;
         }
 
         void pop_back() noexcept {
-            std::destroy_at(data_.get_address() + size_);
+            assert(size_ != 0);
             --size_;
+            std::destroy_at(data_.get_address() + size_);
         }
 
         template<typename ... Args>
         T &emplace_back(Args &&... args) {
+            if constexpr (memory_type::can_reallocate) {
+                if (size_ == capacity()) {
+                    T tmp(std::forward<Args>(args) ...);
+                    reallocate_(next_capacity_(size_ + 1));
+                    new(data_.get_address() + size_) T(std::move(tmp));
+                    ++size_;
+                    return data_[size_ - 1];
+                }
+            }
             if (size_ == capacity()) {
-                auto new_capacity = (size_ == 0) ? 1 : size_ * 2;
-                raw_memory<T> new_data(new_capacity);
+                memory_type new_data = allocate_(next_capacity_(size_ + 1));
                 new(new_data.get_address() + size_) T(std::forward<Args>(args) ...);
-                if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-                    std::uninitialized_move_n(data_.get_address(), size_, new_data.get_address());
+                if constexpr (is_nothrow_relocatable_v<T>) {
+                    uninitialized_relocate_n(data_.get_address(), size_, new_data.get_address());
                 } else {
-                    std::uninitialized_copy_n(data_.get_address(), size_, new_data.get_address());
+                    try {
+                        uninitialized_relocate_n(data_.get_address(), size_, new_data.get_address());
+                    } catch (...) {
+                        std::destroy_at(new_data.get_address() + size_);
+                        throw;
+                    }
                 }
-                std::destroy_n(data_.get_address(), size_);
                 data_.swap(new_data);
             } else {
                 new(data_.get_address() + size_) T(std::forward<Args>(args) ...);
@@ -265,24 +419,31 @@ namespace bmstu {
             iterator res_pos = begin();
             if (pos == cend()) {
                 res_pos = &emplace_back(std::forward<Args>(args) ...);
-            } else if (size_ == data_.capacity()) {
-                auto new_capacity = (size_ == 0) ? 1 : size_ * 2;
-                raw_memory<T> new_data(new_capacity);
+                return res_pos;
+            }
+            if constexpr (memory_type::can_reallocate) {
+                if (size_ == data_.capacity()) {
+                    const size_t dest_pos = pos - begin();
+                    T tmp(std::forward<Args>(args) ...);
+                    reallocate_(next_capacity_(size_ + 1));
+                    return emplace(begin() + dest_pos, std::move(tmp));
+                }
+            }
+            if (size_ == data_.capacity()) {
+                memory_type new_data = allocate_(next_capacity_(size_ + 1));
                 const size_t dest_pos = pos - begin();
-                if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-                    std::uninitialized_move_n(data_.get_address(), dest_pos, new_data.get_address());
+                new(new_data.get_address() + dest_pos) T(std::forward<Args>(args) ...);
+                if constexpr (is_nothrow_relocatable_v<T>) {
+                    uninitialized_relocate_n(data_.get_address(), dest_pos, new_data.get_address());
+                    uninitialized_relocate_n(data_.get_address() + dest_pos, size_ - dest_pos,
+                                             new_data.get_address() + dest_pos + 1);
                 } else {
                     try {
                         std::uninitialized_copy_n(data_.get_address(), dest_pos, new_data.get_address());
                     } catch (...) {
-                        std::destroy_n(new_data + dest_pos, 1);
+                        std::destroy_at(new_data.get_address() + dest_pos);
                         throw;
                     }
-                }
-                if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_nothrow_copy_constructible_v<T>) {
-                    std::uninitialized_move_n(data_.get_address() + dest_pos, size_ - dest_pos,
-                                              new_data.get_address() + dest_pos + 1);
-                } else {
                     try {
                         std::uninitialized_copy_n(data_.get_address() + dest_pos, size_ - dest_pos,
                                                   new_data.get_address() + dest_pos + 1);
@@ -290,23 +451,23 @@ namespace bmstu {
                         std::destroy_n(new_data.get_address(), dest_pos + 1);
                         throw;
                     }
+                    std::destroy_n(data_.get_address(), size_);
                 }
-                if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-                    new_data[dest_pos] = std::move(args...);
-                } else {
-                    std::copy(new_data[dest_pos], args...);
-                }
-                std::destroy_n(data_.get_address(), size_);
                 data_.swap(new_data);
                 res_pos = begin() + dest_pos;
                 ++size_;
                 return res_pos;
             } else {
                 T tmp(std::forward<Args>(args) ...);
-                new(data_.get_address() + size_) T(std::move(data_[size_ - 1]));
                 res_pos = begin() + (pos - begin());
-                std::move_backward(res_pos, end() - 1, end());
-                *res_pos = std::move(tmp);
+                if constexpr (is_trivially_relocatable_v<T> && std::is_nothrow_move_constructible_v<T>) {
+                    trivially_relocate_n(&*res_pos, end() - res_pos, &*res_pos + 1);
+                    new(&*res_pos) T(std::move(tmp));
+                } else {
+                    new(data_.get_address() + size_) T(std::move(data_[size_ - 1]));
+                    std::move_backward(res_pos, end() - 1, end());
+                    *res_pos = std::move(tmp);
+                }
                 ++size_;
                 return res_pos;
             }
@@ -314,28 +475,176 @@ namespace bmstu {
 
         iterator erase(const_iterator pos) {
             iterator res_it = begin() + (pos - begin());
-            std::move(res_it + 1, end(), res_it);
-            std::destroy_n(end() - 1, 1);
+            if constexpr (is_trivially_relocatable_v<T>) {
+                std::destroy_at(&*res_it);
+                trivially_relocate_n(&*res_it + 1, end() - res_it - 1, &*res_it);
+            } else {
+                std::move(res_it + 1, end(), res_it);
+                std::destroy_n(end() - 1, 1);
+            }
             --size_;
             return res_it;
 
         }
 
+        iterator erase(const_iterator first, const_iterator last) {
+            const size_t index = first - begin();
+            const size_t count = last - first;
+            if (count != 0) {
+                T *hole = data_.get_address() + index;
+                T *old_end = data_.get_address() + size_;
+                if constexpr (is_trivially_relocatable_v<T>) {
+                    std::destroy_n(hole, count);
+                    trivially_relocate_n(hole + count, old_end - hole - count, hole);
+                } else {
+                    std::move(hole + count, old_end, hole);
+                    std::destroy_n(old_end - count, count);
+                }
+                size_ -= count;
+            }
+            return begin() + index;
+        }
+
+        iterator unordered_erase(const_iterator pos) {
+            T *target = &*pos;
+            T *last = data_.get_address() + size_ - 1;
+            if constexpr (is_trivially_relocatable_v<T>) {
+                std::destroy_at(target);
+                trivially_relocate_n(last, target != last ? 1 : 0, target);
+                --size_;
+            } else {
+                if (target != last) {
+                    *target = std::move(*last);
+                }
+                pop_back();
+            }
+            return target;
+        }
+
         template<typename Type>
         iterator incert(const_iterator pos, Type &&value) {
             return emplace(pos, std::forward<Type>(value));
         }
 
+        iterator insert(const_iterator pos, const T &value) {
+            return emplace(pos, value);
+        }
+
+        iterator insert(const_iterator pos, T &&value) {
+            return emplace(pos, std::move(value));
+        }
+
+        iterator insert(const_iterator pos, size_t count, const T &value) {
+            const T copy(value);
+            return insert_n_(pos - begin(), repeat_iterator_{&copy}, count);
+        }
+
+        iterator insert(const_iterator pos, std::initializer_list<T> ilist) {
+            return insert_n_(pos - begin(), ilist.begin(), ilist.size());
+        }
+
+        template<std::input_iterator It>
+        iterator insert(const_iterator pos, It first, It last) {
+            const size_t index = pos - begin();
+            if constexpr (std::forward_iterator<It>) {
+                if (aliases_(first)) {
+                    vector tmp(first, last, get_allocator());
+                    return insert_n_(index, std::make_move_iterator(tmp.begin()), tmp.size());
+                }
+                return insert_n_(index, first, static_cast<size_t>(std::distance(first, last)));
+            } else {
+                const size_t old_size = size_;
+                for (; first != last; ++first) {
+                    emplace_back(*first);
+                }
+                std::rotate(begin() + index, begin() + old_size, end());
+                return begin() + index;
+            }
+        }
+
+        template<std::ranges::input_range Range>
+        iterator insert_range(const_iterator pos, Range &&range) {
+            if constexpr (std::ranges::common_range<Range>) {
+                return insert(pos, std::ranges::begin(range), std::ranges::end(range));
+            } else {
+                auto common = range | std::views::common;
+                return insert(pos, common.begin(), common.end());
+            }
+        }
+
+        template<std::ranges::input_range Range>
+        void append_range(Range &&range) {
+            insert_range(cend(), std::forward<Range>(range));
+        }
+
+        template<std::input_iterator It>
+        void assign(It first, It last) {
+            if constexpr (std::forward_iterator<It>) {
+                const auto count = static_cast<size_t>(std::distance(first, last));
+                if (count > capacity()) {
+                    memory_type new_data = allocate_(count);
+                    uninitialized_copy_source_(first, count, new_data.get_address());
+                    std::destroy_n(data_.get_address(), size_);
+                    data_.swap(new_data);
+                } else if (count <= size_) {
+                    std::copy_n(first, count, data_.get_address());
+                    std::destroy_n(data_.get_address() + count, size_ - count);
+                } else {
+                    auto mid = std::next(first, static_cast<std::ptrdiff_t>(size_));
+                    std::copy(first, mid, data_.get_address());
+                    uninitialized_copy_source_(mid, count - size_, data_.get_address() + size_);
+                }
+                size_ = count;
+            } else {
+                clear();
+                for (; first != last; ++first) {
+                    emplace_back(*first);
+                }
+            }
+        }
+
+        void assign(size_t count, const T &value) {
+            const T copy(value);
+            assign(repeat_iterator_{&copy}, repeat_iterator_{&copy, count});
+        }
+
+        // Copy assignment with the strong guarantee: the copy is built in a new buffer and swapped in, so a
+        // throwing element copy leaves *this unchanged. Costs an allocation whenever the copy may throw.
+        void assign_strong(const vector &other) {
+            if constexpr (nothrow_copy_) {
+                *this = other;
+            } else if (this != &other) {
+                vector copy(other, alloc_traits::propagate_on_container_copy_assignment::value ?
+                                   other.get_allocator() : get_allocator());
+                data_.swap_with_allocator(copy.data_);
+                std::swap(size_, copy.size_);
+            }
+        }
+
+        void assign(std::initializer_list<T> ilist) {
+            assign(ilist.begin(), ilist.end());
+        }
+
+        template<std::ranges::input_range Range>
+        void assign_range(Range &&range) {
+            if constexpr (std::ranges::common_range<Range>) {
+                assign(std::ranges::begin(range), std::ranges::end(range));
+            } else {
+                auto common = range | std::views::common;
+                assign(common.begin(), common.end());
+            }
+        }
+
         template<typename Type>
         void push_back(Type &&value) {
             emplace_back(std::forward<Type>(value));
         }
 
-        size_t size() {
+        size_t size() const noexcept {
             return size_;
         }
 
-        size_t capacity() {
+        size_t capacity() const noexcept {
             return data_.capacity();
         }
 
@@ -343,43 +652,56 @@ namespace bmstu {
             return (size_ == 0);
         }
 
-        friend bool operator==(bmstu::vector<T> &l, bmstu::vector<T> &r) {
-            if (l.size() == r.size()) {
+        friend bool operator==(const vector &l, const vector &r) {
+            if (l.size() != r.size()) {
+                return false;
+            }
+            if constexpr (is_bitwise_comparable_v<T>) {
+                return simd::equal(l.data_.get_address(), r.data_.get_address(), l.size_);
+            } else {
                 for (size_t i = 0; i < l.size(); ++i) {
-                    if (l[i] != r[i]) {
+                    if (!(l[i] == r[i])) {
                         return false;
                     }
                 }
                 return true;
             }
-            return false;
         }
 
-        friend bool operator!=(const vector<T> &l, const vector<T> &r) {
+        friend bool operator!=(const vector &l, const vector &r) {
             return !(l == r);
         }
 
-        friend bool operator<(const vector<T> &l, const vector<T> &r) {
+        friend bool operator<(const vector &l, const vector &r) {
             return lexicographical_compare_(l, r);
         }
 
-        friend bool operator>(const vector<T> &l, const vector<T> &r) {
+        friend bool operator>(const vector &l, const vector &r) {
             return (r < l);
         }
 
-        friend bool operator<=(const vector<T> &l, const vector<T> &r) {
+        friend bool operator<=(const vector &l, const vector &r) {
             return !(r < l);
         }
 
-        friend bool operator>=(const vector<T> &l, const vector<T> &r) {
+        friend bool operator>=(const vector &l, const vector &r) {
             return !(l < r);
         }
 
+        friend auto operator<=>(const vector &l, const vector &r) requires std::three_way_comparable<T> {
+            const size_t common = std::min(l.size_, r.size_);
+            const size_t index = mismatch_(l, r, common);
+            if (index != common) {
+                return l[index] <=> r[index];
+            }
+            return std::compare_three_way_result_t<T>(l.size_ <=> r.size_);
+        }
+
         template<class S>
-        friend S &operator<<(S &os, const vector<T> &other) {
-            os << "[" << other[0];
-            for(size_t i = 1; i != other.size_; ++i ){
-                os << ", " << other[i];
+        friend S &operator<<(S &os, const vector &other) {
+            os << "[";
+            for (size_t i = 0; i != other.size_; ++i) {
+                os << (i == 0 ? "" : ", ") << other[i];
             }
             os << "]";
 
@@ -387,24 +709,279 @@ namespace bmstu {
         }
 
     private:
-        static bool lexicographical_compare_(const vector<T> &l, const vector<T> &r) {
-            auto lf = l.begin(), rf = r.begin();
-            for (; (lf != l.end()) && (rf != r.end()); ++lf, ++rf) {
-                if (*lf < *rf) {
-                    return true;
+        static constexpr bool nothrow_copy_ = std::is_nothrow_copy_constructible_v<T> &&
+                                              std::is_nothrow_copy_assignable_v<T>;
+
+        static bool lexicographical_compare_(const vector &l, const vector &r) {
+            if constexpr (is_bitwise_comparable_v<T>) {
+                const size_t common = std::min(l.size_, r.size_);
+                const size_t index = mismatch_(l, r, common);
+                return index == common ? l.size_ < r.size_ : l[index] < r[index];
+            } else {
+                auto lf = l.begin(), rf = r.begin();
+                for (; (lf != l.end()) && (rf != r.end()); ++lf, ++rf) {
+                    if (*lf < *rf) {
+                        return true;
+                    }
+                    if (*rf < *lf) {
+                        return false;
+                    }
+                }
+                return (rf != r.end()) && (lf == l.end());
+            }
+        }
+
+        size_t find_index_(const T &value) const {
+            if constexpr (simd::has_lane_v<T>) {
+                return simd::find(data_.get_address(), size_, value);
+            } else {
+                return std::find(data_.get_address(), data_.get_address() + size_, value) - data_.get_address();
+            }
+        }
+
+        // Index of the first position below n where the elements differ, or n.
+        static size_t mismatch_(const vector &l, const vector &r, size_t n) {
+            if constexpr (is_bitwise_comparable_v<T>) {
+                return simd::mismatch(l.data_.get_address(), r.data_.get_address(), n);
+            } else {
+                size_t i = 0;
+                for (; i < n && l[i] == r[i]; ++i) {
                 }
-                if (*rf < *lf) {
+                return i;
+            }
+        }
+
+        struct repeat_iterator_ {
+            using iterator_category = std::forward_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = T;
+            using pointer = const T *;
+            using reference = const T &;
+
+            const T *value = nullptr;
+            size_t index = 0;
+
+            reference operator*() const {
+                return *value;
+            }
+
+            repeat_iterator_ &operator++() {
+                ++index;
+                return *this;
+            }
+
+            repeat_iterator_ operator++(int) {
+                repeat_iterator_ tmp = *this;
+                ++index;
+                return tmp;
+            }
+
+            friend bool operator==(const repeat_iterator_ &a, const repeat_iterator_ &b) {
+                return a.index == b.index;
+            }
+
+            friend difference_type operator-(const repeat_iterator_ &a, const repeat_iterator_ &b) {
+                return static_cast<difference_type>(a.index - b.index);
+            }
+        };
+
+        template<typename It>
+        bool aliases_(It first) const noexcept {
+            if constexpr (std::is_lvalue_reference_v<std::iter_reference_t<It>> &&
+                          std::is_same_v<std::iter_value_t<It>, T>) {
+                if (size_ == 0) {
                     return false;
                 }
+                const T *ptr = std::addressof(*first);
+                return std::less_equal<>()(data_.get_address(), ptr) &&
+                       std::less<>()(ptr, data_.get_address() + size_);
+            } else {
+                return false;
+            }
+        }
+
+        template<typename It>
+        static void uninitialized_copy_source_(It first, size_t count, T *dest) {
+            if constexpr (std::contiguous_iterator<It> && std::is_trivially_copyable_v<T> &&
+                          std::is_same_v<std::iter_value_t<It>, T>) {
+                if (count != 0) {
+                    std::memcpy(static_cast<void *>(dest), std::to_address(first), count * sizeof(T));
+                }
+            } else {
+                std::uninitialized_copy_n(first, count, dest);
+            }
+        }
+
+        template<typename It>
+        iterator insert_n_(size_t index, It first, size_t count) {
+            if (count == 0) {
+                return begin() + index;
+            }
+            const size_t tail = size_ - index;
+            if (size_ + count > capacity()) {
+                if constexpr (memory_type::can_reallocate) {
+                    reallocate_(next_capacity_(size_ + count));
+                } else {
+                    memory_type new_data = allocate_(next_capacity_(size_ + count));
+                    T *dest = new_data.get_address();
+                    uninitialized_copy_source_(first, count, dest + index);
+                    if constexpr (is_nothrow_relocatable_v<T>) {
+                        uninitialized_relocate_n(data_.get_address(), index, dest);
+                        uninitialized_relocate_n(data_.get_address() + index, tail, dest + index + count);
+                    } else {
+                        try {
+                            std::uninitialized_copy_n(data_.get_address(), index, dest);
+                        } catch (...) {
+                            std::destroy_n(dest + index, count);
+                            throw;
+                        }
+                        try {
+                            std::uninitialized_copy_n(data_.get_address() + index, tail, dest + index + count);
+                        } catch (...) {
+                            std::destroy_n(dest, index + count);
+                            throw;
+                        }
+                        std::destroy_n(data_.get_address(), size_);
+                    }
+                    data_.swap(new_data);
+                    size_ += count;
+                    return begin() + index;
+                }
+            }
+            T *hole = data_.get_address() + index;
+            if constexpr (is_trivially_relocatable_v<T>) {
+                trivially_relocate_n(hole, tail, hole + count);
+                try {
+                    uninitialized_copy_source_(first, count, hole);
+                } catch (...) {
+                    trivially_relocate_n(hole + count, tail, hole);
+                    throw;
+                }
+                size_ += count;
+            } else if (count <= tail) {
+                T *old_end = data_.get_address() + size_;
+                std::uninitialized_move(old_end - count, old_end, old_end);
+                size_ += count;
+                std::move_backward(hole, old_end - count, old_end);
+                std::copy_n(first, count, hole);
+            } else {
+                T *old_end = data_.get_address() + size_;
+                It mid = std::next(first, static_cast<std::ptrdiff_t>(tail));
+                std::uninitialized_copy_n(mid, count - tail, old_end);
+                try {
+                    std::uninitialized_move(hole, old_end, hole + count);
+                } catch (...) {
+                    std::destroy_n(old_end, count - tail);
+                    throw;
+                }
+                size_ += count;
+                std::copy_n(first, tail, hole);
+            }
+            return begin() + index;
+        }
+
+        size_t next_capacity_(size_t required) const noexcept {
+            return GrowthPolicy::next_capacity(data_.capacity(), required, sizeof(T));
+        }
+
+        memory_type allocate_(size_t capacity) const {
+            instrumentation::on_reallocation<T>();
+            memory_type memory(capacity, data_.get_allocator());
+            if constexpr (GrowthPolicy::use_usable_size) {
+                memory.adopt_usable_size();
+            }
+            return memory;
+        }
+
+        void reallocate_(size_t capacity) {
+            instrumentation::on_reallocation<T>();
+            instrumentation::on_relocate<T>(size_, true, false);
+            data_.reallocate(capacity);
+            if constexpr (GrowthPolicy::use_usable_size) {
+                data_.adopt_usable_size();
+            }
+        }
+
+        void change_capacity_(size_t capacity) {
+            if constexpr (memory_type::can_reallocate) {
+                reallocate_(capacity);
+            } else {
+                memory_type new_data = allocate_(capacity);
+                uninitialized_relocate_n(data_.get_address(), size_, new_data.get_address());
+                data_.swap(new_data);
+            }
+        }
+
+        static void value_construct_n_(T *first, size_t n) {
+            if constexpr (std::is_default_constructible_v<T>) {
+                std::uninitialized_value_construct_n(first, n);
+            } else {
+                uint8_t *ptr = reinterpret_cast<uint8_t *>(static_cast<void *>(first));
+                std::fill(ptr, ptr + (n * sizeof(T)), 0);
             }
-            return (rf != r.end()) && (lf == l.end());
         }
 
-        void swap_(vector<T> other) {
-            std::swap(*this, other);
+        static void default_construct_n_(T *first, size_t n) {
+            if constexpr (std::is_default_constructible_v<T>) {
+                std::uninitialized_default_construct_n(first, n);
+            } else {
+                value_construct_n_(first, n);
+            }
+        }
+
+        void steal_(vector &right) {
+            std::destroy_n(data_.get_address(), size_);
+            data_ = std::move(right.data_);
+            size_ = std::exchange(right.size_, 0);
         }
 
-        raw_memory<T> data_;
+        void move_elements_(vector &right) {
+            if (right.size_ > data_.capacity()) {
+                vector tmp(std::move(right), get_allocator());
+                std::destroy_n(data_.get_address(), size_);
+                data_.swap(tmp.data_);
+                size_ = std::exchange(tmp.size_, 0);
+            } else {
+                const size_t common = std::min(size_, right.size_);
+                std::move(right.data_.get_address(), right.data_.get_address() + common, data_.get_address());
+                if (size_ < right.size_) {
+                    std::uninitialized_move_n(right.data_.get_address() + size_, right.size_ - size_,
+                                              data_.get_address() + size_);
+                } else {
+                    std::destroy_n(data_.get_address() + right.size_, size_ - right.size_);
+                }
+                size_ = right.size_;
+            }
+            right.clear();
+        }
+
+        memory_type data_;
         size_t size_ = 0;
     };
-}
\ No newline at end of file
+
+    template<typename T, typename Allocator, typename GrowthPolicy, typename Predicate>
+    size_t erase_if(vector<T, Allocator, GrowthPolicy> &vec, Predicate pred) {
+        auto it = std::remove_if(vec.begin(), vec.end(), pred);
+        const size_t removed = vec.end() - it;
+        vec.erase(it, vec.end());
+        return removed;
+    }
+
+    template<typename T, typename Allocator, typename GrowthPolicy, typename U>
+    size_t erase(vector<T, Allocator, GrowthPolicy> &vec, const U &value) {
+        return erase_if(vec, [&value](const T &elem) { return elem == value; });
+    }
+
+    // Growing a vector of vectors moves the inner buffers with memcpy instead of element by element.
+    template<typename T, typename Allocator, typename GrowthPolicy>
+    struct is_trivially_relocatable<vector<T, Allocator, GrowthPolicy>>
+            : std::bool_constant<is_relocatable_allocator_v<Allocator>> {};
+
+    template<typename T, size_t Alignment = cache_line_size, typename GrowthPolicy = grow_2x>
+    using aligned_vector = vector<T, aligned_allocator<T, Alignment>, GrowthPolicy>;
+
+    namespace pmr {
+        template<typename T, typename GrowthPolicy = grow_2x>
+        using vector = bmstu::vector<T, std::pmr::polymorphic_allocator<T>, GrowthPolicy>;
+    }
+}
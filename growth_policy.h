@@ -0,0 +1,44 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+namespace bmstu {
+    template<size_t Numerator, size_t Denominator>
+    struct grow_by_factor {
+        static_assert(Numerator > Denominator && Denominator != 0);
+
+        static constexpr bool use_usable_size = false;
+
+        static constexpr size_t next_capacity(size_t capacity, size_t required, size_t) noexcept {
+            return std::max({required, capacity * Numerator / Denominator, capacity + 1});
+        }
+    };
+
+    using grow_2x = grow_by_factor<2, 1>;
+    using grow_1_5x = grow_by_factor<3, 2>;
+
+    template<size_t Increment>
+    struct grow_by_increment {
+        static_assert(Increment != 0);
+
+        static constexpr bool use_usable_size = false;
+
+        static constexpr size_t next_capacity(size_t capacity, size_t required, size_t) noexcept {
+            return std::max(required, capacity + Increment);
+        }
+    };
+
+    // Rounds the byte size of every block up to a whole number of pages (or malloc granules for small
+    // blocks) and lets the vector adopt the usable size reported by allocators that know it.
+    template<typename Base = grow_2x, size_t PageSize = 4096>
+    struct grow_page_aware {
+        static constexpr bool use_usable_size = true;
+
+        static constexpr size_t next_capacity(size_t capacity, size_t required, size_t element_size) noexcept {
+            const size_t bytes = Base::next_capacity(capacity, required, element_size) * element_size;
+            const size_t granule = bytes >= PageSize ? PageSize : 2 * sizeof(void *);
+            return (bytes + granule - 1) / granule * granule / element_size;
+        }
+    };
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace bmstu {
+    // Random access iterator that stores the container and an index and reads elements through the
+    // container's operator[]. Used by containers whose elements are not contiguous. Containers whose
+    // operator[] returns a proxy pass it as Reference; such iterators have no operator-> and only claim
+    // the input iterator category, since their reference is not a real reference.
+    template<typename Container, typename Value, typename Reference = Value &>
+    class indexed_iterator {
+        using owner_type = std::conditional_t<std::is_const_v<Value>, const Container, Container>;
+
+    public:
+        using iterator_category = std::conditional_t<std::is_reference_v<Reference>,
+                std::random_access_iterator_tag, std::input_iterator_tag>;
+        using difference_type = std::ptrdiff_t;
+        using value_type = std::remove_const_t<Value>;
+        using pointer = std::conditional_t<std::is_reference_v<Reference>, Value *, void>;
+        using reference = Reference;
+
+        indexed_iterator() = default;
+
+        indexed_iterator(owner_type *owner, size_t index) noexcept : owner_(owner), index_(index) {}
+
+        template<typename ConstReference>
+        operator indexed_iterator<Container, const Value, ConstReference>() const noexcept
+        requires (!std::is_const_v<Value>) {
+            return {owner_, index_};
+        }
+
+        size_t index() const noexcept {
+            return index_;
+        }
+
+        reference operator*() const {
+            return (*owner_)[index_];
+        }
+
+        pointer operator->() const requires std::is_reference_v<Reference> {
+            return &(*owner_)[index_];
+        }
+
+        reference operator[](difference_type n) const {
+            return (*owner_)[index_ + n];
+        }
+
+        indexed_iterator &operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        indexed_iterator operator++(int) noexcept {
+            indexed_iterator tmp = *this;
+            ++index_;
+            return tmp;
+        }
+
+        indexed_iterator &operator--() noexcept {
+            --index_;
+            return *this;
+        }
+
+        indexed_iterator operator--(int) noexcept {
+            indexed_iterator tmp = *this;
+            --index_;
+            return tmp;
+        }
+
+        indexed_iterator &operator+=(difference_type n) noexcept {
+            index_ += n;
+            return *this;
+        }
+
+        indexed_iterator &operator-=(difference_type n) noexcept {
+            index_ -= n;
+            return *this;
+        }
+
+        friend indexed_iterator operator+(indexed_iterator it, difference_type n) noexcept {
+            return it += n;
+        }
+
+        friend indexed_iterator operator+(difference_type n, indexed_iterator it) noexcept {
+            return it += n;
+        }
+
+        friend indexed_iterator operator-(indexed_iterator it, difference_type n) noexcept {
+            return it -= n;
+        }
+
+        friend difference_type operator-(const indexed_iterator &a, const indexed_iterator &b) noexcept {
+            return static_cast<difference_type>(a.index_) - static_cast<difference_type>(b.index_);
+        }
+
+        friend bool operator==(const indexed_iterator &a, const indexed_iterator &b) noexcept {
+            return a.index_ == b.index_;
+        }
+
+        friend auto operator<=>(const indexed_iterator &a, const indexed_iterator &b) noexcept {
+            return a.index_ <=> b.index_;
+        }
+
+    private:
+        owner_type *owner_ = nullptr;
+        size_t index_ = 0;
+    };
+}
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+// Define BMSTU_VECTOR_INSTRUMENTATION to make raw_memory and the vectors count allocations, growth and slack.
+// Without it every hook below is an empty inline function.
+namespace bmstu::instrumentation {
+#ifdef BMSTU_VECTOR_INSTRUMENTATION
+    inline constexpr bool enabled = true;
+#else
+    inline constexpr bool enabled = false;
+#endif
+
+    inline constexpr size_t histogram_buckets = 65;
+
+    struct snapshot {
+        uint64_t allocations = 0;
+        uint64_t deallocations = 0;
+        uint64_t bytes_allocated = 0;
+        uint64_t peak_capacity_bytes = 0;
+        uint64_t reallocations = 0;
+        uint64_t elements_relocated = 0;
+        uint64_t elements_moved = 0;
+        uint64_t elements_copied = 0;
+        uint64_t slack_bytes = 0;
+        std::array<uint64_t, histogram_buckets> size_histogram{};
+        std::array<uint64_t, histogram_buckets> slack_histogram{};
+    };
+
+    class counters {
+    public:
+        void on_allocate(size_t bytes) noexcept {
+            allocations_.fetch_add(1, std::memory_order_relaxed);
+            bytes_allocated_.fetch_add(bytes, std::memory_order_relaxed);
+            uint64_t peak = peak_capacity_bytes_.load(std::memory_order_relaxed);
+            while (peak < bytes && !peak_capacity_bytes_.compare_exchange_weak(peak, bytes, std::memory_order_relaxed)) {
+            }
+        }
+
+        void on_deallocate() noexcept {
+            deallocations_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void on_reallocation() noexcept {
+            reallocations_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void on_relocate(size_t n, bool bytewise, bool moved) noexcept {
+            auto &counter = bytewise ? elements_relocated_ : (moved ? elements_moved_ : elements_copied_);
+            counter.fetch_add(n, std::memory_order_relaxed);
+        }
+
+        void on_release(size_t size, size_t capacity, size_t element_size) noexcept {
+            slack_bytes_.fetch_add((capacity - size) * element_size, std::memory_order_relaxed);
+            size_histogram_[bucket(size)].fetch_add(1, std::memory_order_relaxed);
+            slack_histogram_[bucket(capacity - size)].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        snapshot read() const noexcept {
+            snapshot result;
+            result.allocations = allocations_.load(std::memory_order_relaxed);
+            result.deallocations = deallocations_.load(std::memory_order_relaxed);
+            result.bytes_allocated = bytes_allocated_.load(std::memory_order_relaxed);
+            result.peak_capacity_bytes = peak_capacity_bytes_.load(std::memory_order_relaxed);
+            result.reallocations = reallocations_.load(std::memory_order_relaxed);
+            result.elements_relocated = elements_relocated_.load(std::memory_order_relaxed);
+            result.elements_moved = elements_moved_.load(std::memory_order_relaxed);
+            result.elements_copied = elements_copied_.load(std::memory_order_relaxed);
+            result.slack_bytes = slack_bytes_.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < histogram_buckets; ++i) {
+                result.size_histogram[i] = size_histogram_[i].load(std::memory_order_relaxed);
+                result.slack_histogram[i] = slack_histogram_[i].load(std::memory_order_relaxed);
+            }
+            return result;
+        }
+
+        void reset() noexcept {
+            for (auto *counter: {&allocations_, &deallocations_, &bytes_allocated_, &peak_capacity_bytes_,
+                                 &reallocations_, &elements_relocated_, &elements_moved_, &elements_copied_,
+                                 &slack_bytes_}) {
+                counter->store(0, std::memory_order_relaxed);
+            }
+            for (size_t i = 0; i < histogram_buckets; ++i) {
+                size_histogram_[i].store(0, std::memory_order_relaxed);
+                slack_histogram_[i].store(0, std::memory_order_relaxed);
+            }
+        }
+
+        // Bucket 0 holds zero, bucket k holds values in [2^(k-1), 2^k).
+        static constexpr size_t bucket(size_t value) noexcept {
+            return std::bit_width(value);
+        }
+
+    private:
+        std::atomic<uint64_t> allocations_{0};
+        std::atomic<uint64_t> deallocations_{0};
+        std::atomic<uint64_t> bytes_allocated_{0};
+        std::atomic<uint64_t> peak_capacity_bytes_{0};
+        std::atomic<uint64_t> reallocations_{0};
+        std::atomic<uint64_t> elements_relocated_{0};
+        std::atomic<uint64_t> elements_moved_{0};
+        std::atomic<uint64_t> elements_copied_{0};
+        std::atomic<uint64_t> slack_bytes_{0};
+        std::array<std::atomic<uint64_t>, histogram_buckets> size_histogram_{};
+        std::array<std::atomic<uint64_t>, histogram_buckets> slack_histogram_{};
+    };
+
+    struct registry_entry {
+        std::string type_name;
+        counters *stats;
+    };
+
+    inline counters &global() noexcept {
+        static counters stats;
+        return stats;
+    }
+
+    inline std::mutex &registry_mutex() noexcept {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    inline std::vector<registry_entry> &registry() {
+        static std::vector<registry_entry> entries;
+        return entries;
+    }
+
+    template<typename T>
+    counters &for_type() {
+        static counters *stats = [] {
+            static counters storage;
+            std::lock_guard lock(registry_mutex());
+            registry().push_back({typeid(T).name(), &storage});
+            return &storage;
+        }();
+        return *stats;
+    }
+
+    template<typename T>
+    void on_allocate(size_t n) {
+        if constexpr (enabled) {
+            for_type<T>().on_allocate(n * sizeof(T));
+            global().on_allocate(n * sizeof(T));
+        }
+    }
+
+    template<typename T>
+    void on_deallocate() {
+        if constexpr (enabled) {
+            for_type<T>().on_deallocate();
+            global().on_deallocate();
+        }
+    }
+
+    template<typename T>
+    void on_reallocation() {
+        if constexpr (enabled) {
+            for_type<T>().on_reallocation();
+            global().on_reallocation();
+        }
+    }
+
+    template<typename T>
+    void on_relocate(size_t n, bool bytewise, bool moved) {
+        if constexpr (enabled) {
+            if (n != 0) {
+                for_type<T>().on_relocate(n, bytewise, moved);
+                global().on_relocate(n, bytewise, moved);
+            }
+        }
+    }
+
+    template<typename T>
+    void on_release(size_t size, size_t capacity) {
+        if constexpr (enabled) {
+            if (capacity != 0) {
+                for_type<T>().on_release(size, capacity, sizeof(T));
+                global().on_release(size, capacity, sizeof(T));
+            }
+        }
+    }
+
+    inline void dump(std::ostream &os, const std::string &name, const snapshot &stats) {
+        os << name << ": allocations=" << stats.allocations << " deallocations=" << stats.deallocations
+           << " bytes_allocated=" << stats.bytes_allocated << " peak_capacity_bytes=" << stats.peak_capacity_bytes
+           << " reallocations=" << stats.reallocations << " relocated=" << stats.elements_relocated
+           << " moved=" << stats.elements_moved << " copied=" << stats.elements_copied
+           << " slack_bytes=" << stats.slack_bytes << '\n';
+        auto print_histogram = [&os](const char *title, const std::array<uint64_t, histogram_buckets> &histogram) {
+            const uint64_t peak = *std::max_element(histogram.begin(), histogram.end());
+            if (peak == 0) {
+                return;
+            }
+            os << "  " << title << ":\n";
+            for (size_t i = 0; i < histogram_buckets; ++i) {
+                if (histogram[i] != 0) {
+                    const uint64_t low = i == 0 ? 0 : uint64_t{1} << (i - 1);
+                    os << "    [" << low << ", " << (i == 0 ? 1 : low * 2) << ") " << histogram[i] << ' '
+                       << std::string(std::max<uint64_t>(1, histogram[i] * 40 / peak), '#') << '\n';
+                }
+            }
+        };
+        print_histogram("size at release", stats.size_histogram);
+        print_histogram("slack at release", stats.slack_histogram);
+    }
+
+    inline void dump_all(std::ostream &os) {
+        dump(os, "global", global().read());
+        std::lock_guard lock(registry_mutex());
+        for (const auto &entry: registry()) {
+            dump(os, entry.type_name, entry.stats->read());
+        }
+    }
+}
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include "bmstu_vector.h"
+#include <sstream>
+#include <string>
+
+static_assert(bmstu::instrumentation::enabled);
+
+struct Tracked {
+    int value = 0;
+};
+
+struct CopyOnGrow {
+    std::string value;
+
+    CopyOnGrow(const char *value) : value(value) {}
+
+    CopyOnGrow(const CopyOnGrow &other) = default;
+
+    CopyOnGrow(CopyOnGrow &&other) noexcept(false) = default;
+};
+
+TEST(Instrumentation, CountsAllocationsAndGrowth) {
+    auto &stats = bmstu::instrumentation::for_type<Tracked>();
+    stats.reset();
+    {
+        bmstu::vector<Tracked> vec;
+        for (int i = 0; i < 5; ++i) {
+            vec.push_back(Tracked{i});
+        }
+        ASSERT_EQ(vec.capacity(), 8);
+    }
+    auto snapshot = stats.read();
+    ASSERT_EQ(snapshot.allocations, 4);
+    ASSERT_EQ(snapshot.deallocations, 4);
+    ASSERT_EQ(snapshot.reallocations, 4);
+    ASSERT_EQ(snapshot.bytes_allocated, (1 + 2 + 4 + 8) * sizeof(Tracked));
+    ASSERT_EQ(snapshot.peak_capacity_bytes, 8 * sizeof(Tracked));
+    ASSERT_EQ(snapshot.elements_relocated, 1 + 2 + 4);
+    ASSERT_EQ(snapshot.elements_moved, 0);
+    ASSERT_EQ(snapshot.slack_bytes, 3 * sizeof(Tracked));
+    ASSERT_EQ(snapshot.size_histogram[bmstu::instrumentation::counters::bucket(5)], 1);
+    ASSERT_EQ(snapshot.slack_histogram[bmstu::instrumentation::counters::bucket(3)], 1);
+}
+
+TEST(Instrumentation, SeparatesMovesAndCopies) {
+    auto &copies = bmstu::instrumentation::for_type<CopyOnGrow>();
+    auto &moves = bmstu::instrumentation::for_type<std::string>();
+    copies.reset();
+    moves.reset();
+    bmstu::vector<CopyOnGrow> copied{"a", "b"};
+    copied.reserve(4);
+    bmstu::vector<std::string> moved{"a", "b"};
+    moved.reserve(4);
+    ASSERT_EQ(copies.read().elements_copied, 2);
+    ASSERT_EQ(moves.read().elements_moved, 2);
+}
+
+TEST(Instrumentation, DumpsHistogram) {
+    {
+        bmstu::vector<Tracked> vec(3);
+    }
+    std::ostringstream os;
+    bmstu::instrumentation::dump_all(os);
+    ASSERT_NE(os.str().find("global: allocations="), std::string::npos);
+    ASSERT_NE(os.str().find("size at release"), std::string::npos);
+    ASSERT_NE(os.str().find(typeid(Tracked).name()), std::string::npos);
+}
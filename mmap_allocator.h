@@ -0,0 +1,147 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <malloc.h>
+#include <new>
+#include <sys/mman.h>
+#include <type_traits>
+
+namespace bmstu {
+    // Blocks of at least ThresholdBytes are mapped directly, aligned to 2 MiB and advised with MADV_HUGEPAGE
+    // so transparent huge pages can back them. Such blocks grow and shrink with mremap, which hands the
+    // released tail back to the kernel immediately. Smaller blocks come from malloc.
+    template<typename T, size_t ThresholdBytes = size_t{1} << 21>
+    class mmap_allocator {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "mmap_allocator does not support over-aligned types");
+
+    public:
+        using value_type = T;
+        using propagate_on_container_move_assignment = std::true_type;
+        using is_always_equal = std::true_type;
+
+        static constexpr size_t threshold = ThresholdBytes;
+        static constexpr size_t huge_page_size = size_t{1} << 21;
+
+        template<typename U>
+        struct rebind {
+            using other = mmap_allocator<U, ThresholdBytes>;
+        };
+
+        mmap_allocator() = default;
+
+        template<typename U>
+        mmap_allocator(const mmap_allocator<U, ThresholdBytes> &) noexcept {}
+
+        T *allocate(size_t n) {
+            if (is_mapped_(n)) {
+                return static_cast<T *>(map_(mapping_size_(n)));
+            }
+            return checked_(std::malloc(n * sizeof(T)));
+        }
+
+        void deallocate(T *ptr, size_t n) noexcept {
+            if (is_mapped_(n)) {
+                munmap(ptr, mapping_size_(n));
+            } else {
+                std::free(ptr);
+            }
+        }
+
+        T *reallocate(T *ptr, size_t old_n, size_t new_n) {
+            const bool old_mapped = is_mapped_(old_n);
+            const bool new_mapped = is_mapped_(new_n);
+            if (!old_mapped && !new_mapped) {
+                return checked_(std::realloc(ptr, new_n * sizeof(T)));
+            }
+            if (old_mapped && new_mapped) {
+                const size_t old_size = mapping_size_(old_n);
+                const size_t new_size = mapping_size_(new_n);
+                if (old_size == new_size) {
+                    return ptr;
+                }
+                void *moved = mremap(ptr, old_size, new_size, MREMAP_MAYMOVE);
+                if (moved == MAP_FAILED) {
+                    throw std::bad_alloc();
+                }
+                if (reinterpret_cast<uintptr_t>(moved) % huge_page_size != 0) {
+                    moved = move_to_aligned_(moved, new_size);
+                }
+                madvise(moved, new_size, MADV_HUGEPAGE);
+                return static_cast<T *>(moved);
+            }
+            T *fresh = allocate(new_n);
+            std::memcpy(static_cast<void *>(fresh), ptr, std::min(old_n, new_n) * sizeof(T));
+            deallocate(ptr, old_n);
+            return fresh;
+        }
+
+        size_t usable_size(T *ptr, size_t n) const noexcept {
+            if (is_mapped_(n)) {
+                return mapping_size_(n) / sizeof(T);
+            }
+            return std::min(malloc_usable_size(ptr), ThresholdBytes - 1) / sizeof(T);
+        }
+
+        friend bool operator==(const mmap_allocator &, const mmap_allocator &) noexcept {
+            return true;
+        }
+
+    private:
+        static constexpr bool is_mapped_(size_t n) noexcept {
+            return n * sizeof(T) >= ThresholdBytes;
+        }
+
+        static constexpr size_t mapping_size_(size_t n) noexcept {
+            return (n * sizeof(T) + huge_page_size - 1) / huge_page_size * huge_page_size;
+        }
+
+        static void *map_(size_t size) {
+            const size_t length = size + huge_page_size;
+            void *raw = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (raw == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            const auto raw_address = reinterpret_cast<uintptr_t>(raw);
+            const uintptr_t start = (raw_address + huge_page_size - 1) / huge_page_size * huge_page_size;
+            const size_t head = start - raw_address;
+            const size_t tail = length - head - size;
+            if (head != 0) {
+                munmap(raw, head);
+            }
+            if (tail != 0) {
+                munmap(reinterpret_cast<void *>(start + size), tail);
+            }
+            // Failure only means transparent huge pages are disabled; the mapping stays usable.
+            madvise(reinterpret_cast<void *>(start), size, MADV_HUGEPAGE);
+            return reinterpret_cast<void *>(start);
+        }
+
+        // mremap places a moved block wherever the kernel finds room, which need not be 2 MiB aligned. The block
+        // is then moved once more, onto an aligned range reserved for it. If that fails it stays where it is.
+        static void *move_to_aligned_(void *ptr, size_t size) noexcept {
+            void *target;
+            try {
+                target = map_(size);
+            } catch (const std::bad_alloc &) {
+                return ptr;
+            }
+            void *moved = mremap(ptr, size, size, MREMAP_MAYMOVE | MREMAP_FIXED, target);
+            if (moved == MAP_FAILED) {
+                munmap(target, size);
+                return ptr;
+            }
+            return moved;
+        }
+
+        static T *checked_(void *ptr) {
+            if (!ptr) {
+                throw std::bad_alloc();
+            }
+            return static_cast<T *>(ptr);
+        }
+    };
+}
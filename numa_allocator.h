@@ -0,0 +1,220 @@
+#pragma once
+
+#include "parallel.h"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <type_traits>
+#include <unistd.h>
+
+namespace bmstu {
+    enum class numa_policy {
+        first_touch, interleave, bind
+    };
+
+    // Thin wrappers over the mbind, get_mempolicy and move_pages system calls, so nothing has to link
+    // libnuma. Every call degrades to the kernel's default placement when NUMA is unavailable.
+    namespace numa {
+        namespace detail {
+            inline constexpr int mpol_bind = 2;
+            inline constexpr int mpol_interleave = 3;
+            inline constexpr int mpol_f_mems_allowed = 4;
+            inline constexpr size_t max_node_bits = 1024;
+            inline constexpr size_t mask_words = max_node_bits / 64;
+        }
+
+        inline constexpr size_t max_nodes = 64;
+
+        inline size_t page_size() noexcept {
+            static const auto size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            return size;
+        }
+
+        // Nodes this process may allocate on, one bit per node. Without NUMA support only node 0 is set.
+        inline uint64_t allowed_nodes() noexcept {
+            static const uint64_t mask = [] {
+                unsigned long nodes[detail::mask_words] = {};
+                if (syscall(SYS_get_mempolicy, nullptr, nodes, detail::max_node_bits + 1, nullptr,
+                            detail::mpol_f_mems_allowed) != 0 || nodes[0] == 0) {
+                    return uint64_t{1};
+                }
+                return static_cast<uint64_t>(nodes[0]);
+            }();
+            return mask;
+        }
+
+        inline size_t node_count() noexcept {
+            return static_cast<size_t>(std::popcount(allowed_nodes()));
+        }
+
+        // Sets the policy of the page-aligned range [ptr, ptr + bytes) for pages not yet touched. Returns false
+        // when the kernel refuses, for example without NUMA support, for a node that does not exist or under a
+        // seccomp filter; the range then keeps first-touch placement.
+        inline bool apply(void *ptr, size_t bytes, numa_policy policy, size_t node = 0) noexcept {
+            if (policy == numa_policy::first_touch || bytes == 0) {
+                return true;
+            }
+            unsigned long nodes[detail::mask_words] = {};
+            int mode = detail::mpol_interleave;
+            if (policy == numa_policy::interleave) {
+                nodes[0] = allowed_nodes();
+            } else if (node < max_nodes) {
+                nodes[0] = uint64_t{1} << node;
+                mode = detail::mpol_bind;
+            } else {
+                return false;
+            }
+            return syscall(SYS_mbind, ptr, bytes, mode, nodes, detail::max_node_bits + 1, 0) == 0;
+        }
+
+        // Number of pages of [ptr, ptr + bytes) on each node, indexed by node. Pages that were never touched are
+        // not counted. When move_pages is unavailable every resident page is reported on node 0.
+        inline vector<size_t> pages_per_node(const void *ptr, size_t bytes) {
+            vector<size_t> result(1);
+            if (bytes == 0) {
+                return result;
+            }
+            const size_t page = page_size();
+            const auto first = reinterpret_cast<uintptr_t>(ptr) / page * page;
+            const size_t pages = (reinterpret_cast<uintptr_t>(ptr) + bytes - first + page - 1) / page;
+            constexpr size_t batch = 1024;
+            void *addresses[batch];
+            int status[batch];
+            for (size_t done = 0; done < pages; done += batch) {
+                const size_t n = std::min(batch, pages - done);
+                for (size_t i = 0; i < n; ++i) {
+                    addresses[i] = reinterpret_cast<void *>(first + (done + i) * page);
+                }
+                if (syscall(SYS_move_pages, 0, n, addresses, nullptr, status, 0) != 0) {
+                    vector<unsigned char> resident(pages);
+                    result[0] = 0;
+                    if (mincore(reinterpret_cast<void *>(first), pages * page, &resident[0]) == 0) {
+                        result[0] = static_cast<size_t>(std::count_if(resident.begin(), resident.end(),
+                                                                      [](unsigned char r) { return r & 1; }));
+                    }
+                    result.resize(1);
+                    return result;
+                }
+                for (size_t i = 0; i < n; ++i) {
+                    if (status[i] >= 0) {
+                        const auto node = static_cast<size_t>(status[i]);
+                        if (node >= result.size()) {
+                            result.resize(node + 1);
+                        }
+                        ++result[node];
+                    }
+                }
+            }
+            return result;
+        }
+    }
+
+    // Places blocks of a page or more with a NUMA policy. They are mapped fresh, so no page exists until it is
+    // written: under first_touch each page lands on the node of the thread that writes it first, and
+    // parallel::first_touch_resize spreads those writes over a pool. Smaller blocks come from operator new.
+    // Any instance can free any block, so allocators compare equal whatever their policy.
+    template<typename T>
+    class numa_allocator {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "numa_allocator does not support over-aligned types");
+
+    public:
+        using value_type = T;
+        using propagate_on_container_move_assignment = std::true_type;
+        using is_always_equal = std::true_type;
+
+        numa_allocator() = default;
+
+        explicit numa_allocator(numa_policy policy, size_t node = 0) noexcept : policy_(policy), node_(node) {}
+
+        template<typename U>
+        numa_allocator(const numa_allocator<U> &other) noexcept : policy_(other.policy()), node_(other.node()) {}
+
+        T *allocate(size_t n) {
+            if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+                throw std::bad_array_new_length();
+            }
+            const size_t bytes = n * sizeof(T);
+            if (!is_mapped_(bytes)) {
+                return static_cast<T *>(::operator new(bytes));
+            }
+            void *ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (ptr == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            numa::apply(ptr, bytes, policy_, node_);
+            return static_cast<T *>(ptr);
+        }
+
+        void deallocate(T *ptr, size_t n) noexcept {
+            const size_t bytes = n * sizeof(T);
+            if (is_mapped_(bytes)) {
+                munmap(ptr, bytes);
+            } else {
+                ::operator delete(ptr, bytes);
+            }
+        }
+
+        numa_policy policy() const noexcept {
+            return policy_;
+        }
+
+        size_t node() const noexcept {
+            return node_;
+        }
+
+        friend bool operator==(const numa_allocator &, const numa_allocator &) noexcept {
+            return true;
+        }
+
+    private:
+        static bool is_mapped_(size_t bytes) noexcept {
+            return bytes >= numa::page_size();
+        }
+
+        numa_policy policy_ = numa_policy::first_touch;
+        size_t node_ = 0;
+    };
+
+    namespace parallel {
+        // Start of block i when the n elements at first are split into `blocks` contiguous runs of nearly equal
+        // length, each starting on a page boundary, so no page is shared by two blocks unless an element
+        // straddles it. Block i is [block_boundary(first, n, blocks, i), block_boundary(first, n, blocks, i + 1)).
+        template<typename T>
+        size_t block_boundary(const T *first, size_t n, size_t blocks, size_t i) noexcept {
+            if (i >= blocks) {
+                return n;
+            }
+            const size_t page = numa::page_size();
+            const auto start = reinterpret_cast<uintptr_t>(first);
+            const uintptr_t target = start + n / blocks * i * sizeof(T) + n % blocks * i / blocks * sizeof(T);
+            const uintptr_t aligned = (target + page - 1) / page * page;
+            return std::min(n, (aligned - start + sizeof(T) - 1) / sizeof(T));
+        }
+
+        // Grows vec to n copies of value. The new elements are split into one page-aligned block per pool
+        // thread and block i is written by thread i of thread_pool::run_per_thread, so under first_touch each
+        // block's pages sit on the node of the thread that filled it. Pages are only untouched in a fresh
+        // allocation, so call it on a vector without spare capacity.
+        template<typename T, typename Allocator, typename GrowthPolicy>
+        requires (std::is_trivially_default_constructible_v<T> && std::is_trivially_copyable_v<T>)
+        void first_touch_resize(vector<T, Allocator, GrowthPolicy> &vec, size_t n, const T &value = T(),
+                                thread_pool &pool = default_pool()) {
+            const size_t old_size = vec.size();
+            vec.resize_for_overwrite(n);
+            if (n > old_size) {
+                T *first = vec.data() + old_size;
+                const size_t count = n - old_size;
+                const size_t blocks = pool.concurrency();
+                pool.run_per_thread([&](size_t i) {
+                    std::fill(first + block_boundary(first, count, blocks, i),
+                              first + block_boundary(first, count, blocks, i + 1), value);
+                });
+            }
+        }
+    }
+}
@@ -0,0 +1,330 @@
+#pragma once
+
+#include "bmstu_vector.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace bmstu::parallel {
+    // Below this many elements every algorithm here runs on the calling thread.
+    inline constexpr size_t serial_threshold = size_t{1} << 15;
+
+    // Fixed set of workers that execute one indexed batch at a time. Workers and the calling thread claim
+    // task indices from a shared counter, so a thread that finishes early keeps taking work from the rest.
+    // A batch started from inside a task runs inline on that thread.
+    class thread_pool {
+    public:
+        explicit thread_pool(size_t threads = std::max(1u, std::thread::hardware_concurrency())) {
+            for (size_t i = 1; i < threads; ++i) {
+                workers_.emplace_back([this, i] { work_(i); });
+            }
+        }
+
+        thread_pool(const thread_pool &) = delete;
+
+        thread_pool &operator=(const thread_pool &) = delete;
+
+        ~thread_pool() {
+            {
+                std::lock_guard lock(mutex_);
+                stop_ = true;
+            }
+            wake_.notify_all();
+            for (auto &worker: workers_) {
+                worker.join();
+            }
+        }
+
+        size_t concurrency() const noexcept {
+            return workers_.size() + 1;
+        }
+
+        // Calls task(i) for every i in [0, tasks) and returns when all calls have finished. The first
+        // exception thrown by a task is rethrown here; tasks not yet started are skipped.
+        template<typename F>
+        void run(size_t tasks, F &&task) {
+            if (tasks == 0) {
+                return;
+            }
+            if (inside_task_ || workers_.empty() || tasks == 1) {
+                for (size_t i = 0; i < tasks; ++i) {
+                    task(i);
+                }
+                return;
+            }
+            dispatch_(task, tasks, false);
+        }
+
+        // Calls task(i) exactly once on every pool thread, with a fixed i per thread: 0 on the calling thread
+        // and k on the k-th worker. Unlike run, which thread handles which index is deterministic, which
+        // matters for work such as first-touch page placement. Inside a task all calls run inline.
+        template<typename F>
+        void run_per_thread(F &&task) {
+            if (inside_task_ || workers_.empty()) {
+                for (size_t i = 0; i < concurrency(); ++i) {
+                    task(i);
+                }
+                return;
+            }
+            dispatch_(task, concurrency(), true);
+        }
+
+    private:
+        // One published batch. Workers copy it under mutex_, and a new one is only published once no worker
+        // is still inside the previous one.
+        struct batch {
+            void *context = nullptr;
+            void (*invoke)(void *, size_t) = nullptr;
+            size_t total = 0;
+            bool per_thread = false;
+        };
+
+        template<typename F>
+        void dispatch_(F &task, size_t tasks, bool per_thread) {
+            std::lock_guard batch_lock(batch_mutex_);
+            batch current;
+            current.context = std::addressof(task);
+            current.invoke = [](void *context, size_t i) {
+                (*static_cast<std::remove_reference_t<F> *>(context))(i);
+            };
+            current.total = tasks;
+            current.per_thread = per_thread;
+            {
+                std::unique_lock lock(mutex_);
+                idle_.wait(lock, [this] { return active_ == 0; });
+                batch_ = current;
+                next_.store(0, std::memory_order_release);
+                error_ = nullptr;
+                pending_ = per_thread ? workers_.size() : 0;
+                ++generation_;
+            }
+            wake_.notify_all();
+            if (per_thread) {
+                run_own_(current, 0);
+            } else {
+                drain_(current);
+            }
+            std::unique_lock lock(mutex_);
+            idle_.wait(lock, [this] { return active_ == 0 && pending_ == 0; });
+            batch_ = batch{};
+            if (error_) {
+                std::rethrow_exception(std::exchange(error_, nullptr));
+            }
+        }
+
+        void work_(size_t index) {
+            uint64_t seen = 0;
+            std::unique_lock lock(mutex_);
+            for (;;) {
+                wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+                if (stop_) {
+                    return;
+                }
+                seen = generation_;
+                ++active_;
+                const batch current = batch_;
+                lock.unlock();
+                if (current.per_thread) {
+                    run_own_(current, index);
+                } else {
+                    drain_(current);
+                }
+                lock.lock();
+                if (current.per_thread) {
+                    --pending_;
+                }
+                if (--active_ == 0) {
+                    idle_.notify_all();
+                }
+            }
+        }
+
+        void record_error_() {
+            std::lock_guard lock(mutex_);
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+        }
+
+        void run_own_(const batch &current, size_t index) {
+            inside_task_ = true;
+            try {
+                current.invoke(current.context, index);
+            } catch (...) {
+                record_error_();
+            }
+            inside_task_ = false;
+        }
+
+        void drain_(const batch &current) {
+            inside_task_ = true;
+            for (size_t i = next_.fetch_add(1, std::memory_order_acq_rel); i < current.total;
+                 i = next_.fetch_add(1, std::memory_order_acq_rel)) {
+                try {
+                    current.invoke(current.context, i);
+                } catch (...) {
+                    record_error_();
+                    next_.store(current.total, std::memory_order_relaxed);
+                }
+            }
+            inside_task_ = false;
+        }
+
+        static inline thread_local bool inside_task_ = false;
+
+        std::vector<std::thread> workers_;
+        std::mutex batch_mutex_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::condition_variable idle_;
+        uint64_t generation_ = 0;
+        size_t active_ = 0;
+        size_t pending_ = 0;
+        bool stop_ = false;
+        batch batch_;
+        std::atomic<size_t> next_{0};
+        std::exception_ptr error_;
+    };
+
+    inline thread_pool &default_pool() {
+        static thread_pool pool;
+        return pool;
+    }
+
+    namespace detail {
+        inline size_t chunk_count(size_t n, const thread_pool &pool) noexcept {
+            if (n < serial_threshold) {
+                return 1;
+            }
+            return std::min(pool.concurrency() * 4, n / (serial_threshold / 4));
+        }
+
+        // Splits [0, n) into contiguous chunks and calls body(begin, end) for each of them on the pool.
+        template<typename F>
+        void for_chunks(size_t n, thread_pool &pool, F &&body) {
+            if (n == 0) {
+                return;
+            }
+            const size_t chunks = chunk_count(n, pool);
+            pool.run(chunks, [&](size_t c) {
+                body(n * c / chunks, n * (c + 1) / chunks);
+            });
+        }
+    }
+
+    template<typename T, typename Allocator, typename GrowthPolicy, typename F>
+    void for_each(vector<T, Allocator, GrowthPolicy> &vec, F f, thread_pool &pool = default_pool()) {
+        detail::for_chunks(vec.size(), pool, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                f(vec[i]);
+            }
+        });
+    }
+
+    template<typename T, typename Allocator, typename GrowthPolicy, typename U>
+    void fill(vector<T, Allocator, GrowthPolicy> &vec, const U &value, thread_pool &pool = default_pool()) {
+        detail::for_chunks(vec.size(), pool, [&](size_t begin, size_t end) {
+            std::fill(vec.begin() + begin, vec.begin() + end, value);
+        });
+    }
+
+    // Resizes dst to src.size() and sets dst[i] = f(src[i]). src and dst may be the same vector.
+    template<typename T, typename A1, typename G1, typename U, typename A2, typename G2, typename F>
+    void transform(const vector<T, A1, G1> &src, vector<U, A2, G2> &dst, F f, thread_pool &pool = default_pool()) {
+        dst.resize(src.size());
+        detail::for_chunks(src.size(), pool, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                dst[i] = f(src[i]);
+            }
+        });
+    }
+
+    // Op must be associative: chunks are folded separately and the partial results combined in order.
+    template<typename T, typename Allocator, typename GrowthPolicy, typename U, typename Op = std::plus<>>
+    U reduce(const vector<T, Allocator, GrowthPolicy> &vec, U init, Op op = {}, thread_pool &pool = default_pool()) {
+        const size_t n = vec.size();
+        const size_t chunks = detail::chunk_count(n, pool);
+        if (chunks == 1) {
+            for (size_t i = 0; i < n; ++i) {
+                init = op(std::move(init), vec[i]);
+            }
+            return init;
+        }
+        std::vector<U> partial;
+        partial.reserve(chunks);
+        for (size_t c = 0; c < chunks; ++c) {
+            partial.emplace_back(vec[n * c / chunks]);
+        }
+        pool.run(chunks, [&](size_t c) {
+            U &acc = partial[c];
+            for (size_t i = n * c / chunks + 1, end = n * (c + 1) / chunks; i < end; ++i) {
+                acc = op(std::move(acc), vec[i]);
+            }
+        });
+        for (auto &value: partial) {
+            init = op(std::move(init), std::move(value));
+        }
+        return init;
+    }
+
+    // Sorts 2^k chunks concurrently, then merges neighbouring runs pairwise, each round in parallel.
+    template<typename T, typename Allocator, typename GrowthPolicy, typename Compare = std::less<>>
+    void sort(vector<T, Allocator, GrowthPolicy> &vec, Compare comp = {}, thread_pool &pool = default_pool()) {
+        const size_t n = vec.size();
+        const size_t chunks = std::bit_floor(detail::chunk_count(n, pool));
+        auto first = vec.begin();
+        pool.run(chunks, [&](size_t c) {
+            std::sort(first + n * c / chunks, first + n * (c + 1) / chunks, comp);
+        });
+        for (size_t width = 1; width < chunks; width *= 2) {
+            pool.run(chunks / (2 * width), [&](size_t pair) {
+                const size_t left = pair * 2 * width;
+                std::inplace_merge(first + n * left / chunks, first + n * (left + width) / chunks,
+                                   first + n * (left + 2 * width) / chunks, comp);
+            });
+        }
+    }
+
+    // Copy-assigns src into dst. Trivially copyable elements are copied with memcpy per chunk; other types
+    // are copy-assigned over existing or default-constructed elements, or copied serially when that is
+    // not possible.
+    template<typename T, typename Allocator, typename GrowthPolicy>
+    void assign(vector<T, Allocator, GrowthPolicy> &dst, const vector<T, Allocator, GrowthPolicy> &src,
+                thread_pool &pool = default_pool()) {
+        if (&dst == &src) {
+            return;
+        }
+        const size_t n = src.size();
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            dst.clear();
+            dst.resize_for_overwrite(n);
+            detail::for_chunks(n, pool, [&](size_t begin, size_t end) {
+                std::memcpy(static_cast<void *>(&dst[begin]), &src[begin], (end - begin) * sizeof(T));
+            });
+        } else if constexpr (std::is_default_constructible_v<T> && std::is_copy_assignable_v<T>) {
+            dst.resize(n);
+            detail::for_chunks(n, pool, [&](size_t begin, size_t end) {
+                std::copy(src.begin() + begin, src.begin() + end, dst.begin() + begin);
+            });
+        } else {
+            dst = src;
+        }
+    }
+
+    template<typename T, typename Allocator, typename GrowthPolicy>
+    vector<T, Allocator, GrowthPolicy> copy(const vector<T, Allocator, GrowthPolicy> &src,
+                                            thread_pool &pool = default_pool()) {
+        vector<T, Allocator, GrowthPolicy> result(
+                std::allocator_traits<Allocator>::select_on_container_copy_construction(src.get_allocator()));
+        assign(result, src, pool);
+        return result;
+    }
+}
@@ -1,31 +1,63 @@
 #pragma once
 
+#include "relocation.h"
+#include <algorithm>
 #include <memory>
 #include <cassert>
+#include <concepts>
+#include <utility>
 
 namespace bmstu {
-    template<typename T>
+    template<typename T, typename Allocator = std::allocator<T>>
     class raw_memory {
+        using alloc_traits = std::allocator_traits<Allocator>;
+
     public:
+        using allocator_type = Allocator;
+
+        // Alignment of every buffer: the allocator's alignment member when it has one, otherwise the type's.
+        static constexpr size_t alignment = [] {
+            if constexpr (requires { { Allocator::alignment } -> std::convertible_to<size_t>; }) {
+                return std::max<size_t>(Allocator::alignment, alignof(T));
+            } else {
+                return alignof(T);
+            }
+        }();
+
+        static constexpr bool can_reallocate = is_trivially_relocatable_v<T> &&
+                                               requires(Allocator &alloc, T *ptr, size_t n) {
+                                                   { alloc.reallocate(ptr, n, n) } -> std::same_as<T *>;
+                                               };
+
         raw_memory() = default;
 
-        explicit raw_memory(size_t cap) : buffer_(allocate_(cap)), capacity_(cap) {}
+        explicit raw_memory(const Allocator &alloc) noexcept : alloc_(alloc) {}
+
+        explicit raw_memory(size_t cap, const Allocator &alloc = Allocator()) : alloc_(alloc),
+                                                                                buffer_(allocate_(cap)),
+                                                                                capacity_(cap) {}
 
         raw_memory(const raw_memory &other) = delete;
 
         raw_memory &operator=(const raw_memory &other) = delete;
 
         raw_memory &operator=(raw_memory &&other) noexcept {
-            if (buffer_) {
-                deallocate_(buffer_);
+            if (this != &other) {
+                deallocate_(buffer_, capacity_);
+                if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+                    alloc_ = std::move(other.alloc_);
+                } else {
+                    assert(alloc_ == other.alloc_);
+                }
+                buffer_ = std::exchange(other.buffer_, nullptr);
+                capacity_ = std::exchange(other.capacity_, 0);
             }
-            buffer_ = std::exchange(other.buffer_, nullptr);
-            capacity_ = std::exchange(other.capacity_, 0);
             return *this;
         }
 
-        raw_memory(raw_memory &&other) : buffer_(std::exchange(other.buffer_, nullptr)),
-                                         capacity_(std::exchange(other.capacity_, 0)) {}
+        raw_memory(raw_memory &&other) noexcept : alloc_(std::move(other.alloc_)),
+                                                  buffer_(std::exchange(other.buffer_, nullptr)),
+                                                  capacity_(std::exchange(other.capacity_, 0)) {}
 
         T *operator+(size_t offset) noexcept {
             assert(offset <= capacity_);
@@ -50,29 +82,91 @@ namespace bmstu {
             return buffer_;
         }
 
+        Allocator get_allocator() const noexcept {
+            return alloc_;
+        }
+
         const T &operator[](size_t index) const noexcept {
             return const_cast<raw_memory &> (*this)[index];
         }
 
-        void swap(raw_memory &other) {
+        void swap(raw_memory &other) noexcept {
+            if constexpr (alloc_traits::propagate_on_container_swap::value) {
+                using std::swap;
+                swap(alloc_, other.alloc_);
+            } else {
+                assert(alloc_ == other.alloc_);
+            }
+            std::swap(capacity_, other.capacity_);
+            std::swap(buffer_, other.buffer_);
+        }
+
+        // Swaps the allocators along with the buffers whatever propagate_on_container_swap says, for a container
+        // that has already decided its allocator must change, as copy assignment does when it propagates.
+        void swap_with_allocator(raw_memory &other) noexcept {
+            using std::swap;
+            swap(alloc_, other.alloc_);
             std::swap(capacity_, other.capacity_);
             std::swap(buffer_, other.buffer_);
         }
 
+        void reallocate(size_t new_cap) requires can_reallocate {
+            if (new_cap == 0) {
+                deallocate_(buffer_, capacity_);
+                buffer_ = nullptr;
+            } else if (buffer_) {
+                buffer_ = alloc_.reallocate(buffer_, capacity_, new_cap);
+                instrumentation::on_deallocate<T>();
+                instrumentation::on_allocate<T>(new_cap);
+            } else {
+                buffer_ = allocate_(new_cap);
+            }
+            capacity_ = new_cap;
+        }
+
+        void adopt_usable_size() noexcept {
+            if constexpr (requires(const Allocator &alloc, T *ptr, size_t n) {
+                { alloc.usable_size(ptr, n) } -> std::convertible_to<size_t>;
+            }) {
+                if (buffer_) {
+                    capacity_ = alloc_.usable_size(buffer_, capacity_);
+                }
+            }
+        }
+
         ~raw_memory() {
-            deallocate_(buffer_);
+            deallocate_(buffer_, capacity_);
         }
 
     private:
         T *allocate_(size_t n) {
-            return n != 0 ? static_cast<T *>(operator new(n * sizeof(T))) : nullptr;
+            if (n == 0) {
+                return nullptr;
+            }
+            T *buffer = std::to_address(alloc_traits::allocate(alloc_, n));
+            instrumentation::on_allocate<T>(n);
+            return buffer;
         }
 
-        void deallocate_(T *buffer) {
-            operator delete(buffer);
+        void deallocate_(T *buffer, size_t n) {
+            if (buffer) {
+                alloc_traits::deallocate(alloc_, buffer, n);
+                instrumentation::on_deallocate<T>();
+            }
         }
 
-        size_t capacity_ = 0;
+        [[no_unique_address]] Allocator alloc_;
         T *buffer_ = nullptr;
+        size_t capacity_ = 0;
     };
-}
\ No newline at end of file
+
+    // raw_memory is an allocator, a pointer and a capacity, none of which point back into the object, so it
+    // can be relocated with memcpy whenever its allocator can. Stateless allocators always can.
+    template<typename Allocator>
+    inline constexpr bool is_relocatable_allocator_v = std::is_empty_v<Allocator> ||
+                                                       is_trivially_relocatable_v<Allocator>;
+
+    template<typename T, typename Allocator>
+    struct is_trivially_relocatable<raw_memory<T, Allocator>>
+            : std::bool_constant<is_relocatable_allocator_v<Allocator>> {};
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+#include <type_traits>
+
+namespace bmstu {
+    // malloc-backed allocator that lets raw_memory grow trivially relocatable buffers with realloc.
+    // glibc serves large blocks with mmap and resizes them with mremap, so growing a multi-megabyte
+    // buffer mostly remaps pages instead of copying them.
+    template<typename T>
+    class realloc_allocator {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "realloc_allocator does not support over-aligned types");
+
+    public:
+        using value_type = T;
+        using propagate_on_container_move_assignment = std::true_type;
+        using is_always_equal = std::true_type;
+
+        realloc_allocator() = default;
+
+        template<typename U>
+        realloc_allocator(const realloc_allocator<U> &) noexcept {}
+
+        T *allocate(size_t n) {
+            return checked_(std::malloc(n * sizeof(T)));
+        }
+
+        void deallocate(T *ptr, size_t) noexcept {
+            std::free(ptr);
+        }
+
+        T *reallocate(T *ptr, size_t, size_t new_n) {
+            return checked_(std::realloc(ptr, new_n * sizeof(T)));
+        }
+
+        size_t usable_size(T *ptr, size_t) const noexcept {
+            return malloc_usable_size(ptr) / sizeof(T);
+        }
+
+        friend bool operator==(const realloc_allocator &, const realloc_allocator &) noexcept {
+            return true;
+        }
+
+    private:
+        static T *checked_(void *ptr) {
+            if (!ptr) {
+                throw std::bad_alloc();
+            }
+            return static_cast<T *>(ptr);
+        }
+    };
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "instrumentation.h"
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+namespace bmstu {
+    // Specialize for types whose objects can be moved to another address with a plain byte copy,
+    // after which the source is treated as already destroyed.
+    template<typename T>
+    struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+    template<typename T>
+    struct is_trivially_relocatable<std::unique_ptr<T, std::default_delete<T>>> : std::true_type {};
+
+    template<typename T>
+    struct is_trivially_relocatable<std::shared_ptr<T>> : std::true_type {};
+
+    template<typename T>
+    inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+    template<typename T>
+    inline constexpr bool is_nothrow_relocatable_v =
+            is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T> ||
+            !std::is_copy_constructible_v<T>;
+
+    template<typename T>
+    void trivially_relocate_n(T *src, size_t n, T *dst) noexcept {
+        static_assert(is_trivially_relocatable_v<T>);
+        if (n != 0 && src != dst) {
+            std::memmove(static_cast<void *>(dst), static_cast<const void *>(src), n * sizeof(T));
+        }
+    }
+
+    template<typename T>
+    void uninitialized_relocate_n(T *src, size_t n, T *dst) {
+        instrumentation::on_relocate<T>(n, is_trivially_relocatable_v<T>, is_nothrow_relocatable_v<T>);
+        if constexpr (is_trivially_relocatable_v<T>) {
+            if (n != 0) {
+                std::memcpy(static_cast<void *>(dst), static_cast<const void *>(src), n * sizeof(T));
+            }
+        } else if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            std::uninitialized_move_n(src, n, dst);
+            std::destroy_n(src, n);
+        } else {
+            std::uninitialized_copy_n(src, n, dst);
+            std::destroy_n(src, n);
+        }
+    }
+}
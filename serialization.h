@@ -0,0 +1,364 @@
+#pragma once
+
+#include "bmstu_vector.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <unistd.h>
+
+namespace bmstu {
+    // Stream header written in front of every vector. Values are stored in native byte order.
+    struct serial_header {
+        static constexpr uint32_t magic_value = 0x56534D42;  // "BMSV" read as little-endian
+        static constexpr uint16_t current_version = 1;
+        static constexpr uint16_t bulk_flag = 1;
+
+        uint32_t magic;
+        uint16_t version;
+        uint16_t flags;
+        uint64_t element_size;
+        uint64_t count;
+    };
+
+    // Customization point for element types that are not trivially copyable. A specialization provides
+    //     template<typename Sink> static void write(Sink &sink, const T &value);
+    //     template<typename Source> static T read(Source &source);
+    // where a sink has write(const void *, size_t) and a source has read(void *, size_t).
+    template<typename T>
+    struct serializer;
+
+    class fd_sink {
+    public:
+        explicit fd_sink(int fd) : fd_(fd), buffer_(new std::byte[buffer_size]) {}
+
+        fd_sink(const fd_sink &) = delete;
+
+        fd_sink &operator=(const fd_sink &) = delete;
+
+        ~fd_sink() {
+            try {
+                flush();
+            } catch (...) {
+            }
+        }
+
+        void write(const void *data, size_t n) {
+            if (used_ + n <= buffer_size) {
+                std::memcpy(buffer_.get() + used_, data, n);
+                used_ += n;
+                return;
+            }
+            flush();
+            if (n >= buffer_size) {
+                write_all_(static_cast<const std::byte *>(data), n);
+            } else {
+                std::memcpy(buffer_.get(), data, n);
+                used_ = n;
+            }
+        }
+
+        void flush() {
+            write_all_(buffer_.get(), used_);
+            used_ = 0;
+        }
+
+        static constexpr size_t buffer_size = size_t{1} << 16;
+
+    private:
+        void write_all_(const std::byte *data, size_t n) {
+            while (n != 0) {
+                const ssize_t written = ::write(fd_, data, std::min(n, max_chunk_));
+                if (written < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    throw std::system_error(errno, std::generic_category(), "write");
+                }
+                data += written;
+                n -= static_cast<size_t>(written);
+            }
+        }
+
+        static constexpr size_t max_chunk_ = size_t{1} << 30;
+
+        int fd_;
+        std::unique_ptr<std::byte[]> buffer_;
+        size_t used_ = 0;
+    };
+
+    // Reads ahead into a private buffer unless `exact` is set, in which case every read asks the kernel for
+    // exactly the bytes requested and nothing past them is consumed.
+    class fd_source {
+    public:
+        explicit fd_source(int fd, bool exact = false) : fd_(fd),
+                                                         buffer_(exact ? nullptr : new std::byte[buffer_size]) {}
+
+        fd_source(const fd_source &) = delete;
+
+        fd_source &operator=(const fd_source &) = delete;
+
+        void read(void *data, size_t n) {
+            auto *out = static_cast<std::byte *>(data);
+            if (!buffer_) {
+                read_all_(out, n);
+                return;
+            }
+            const size_t buffered = std::min(n, end_ - begin_);
+            std::memcpy(out, buffer_.get() + begin_, buffered);
+            begin_ += buffered;
+            out += buffered;
+            n -= buffered;
+            if (n >= buffer_size) {
+                read_all_(out, n);
+            } else if (n != 0) {
+                begin_ = 0;
+                end_ = read_some_(buffer_.get(), buffer_size, n);
+                std::memcpy(out, buffer_.get(), n);
+                begin_ = n;
+            }
+        }
+
+        // Seeks the descriptor back over bytes read ahead but not consumed. Returns false when there were
+        // some and the descriptor cannot seek, as with pipes and sockets.
+        [[nodiscard]] bool unread_lookahead() {
+            const size_t unread = end_ - begin_;
+            if (unread == 0) {
+                return true;
+            }
+            if (::lseek(fd_, -static_cast<off_t>(unread), SEEK_CUR) < 0) {
+                if (errno == ESPIPE) {
+                    return false;
+                }
+                throw std::system_error(errno, std::generic_category(), "lseek");
+            }
+            begin_ = end_ = 0;
+            return true;
+        }
+
+        static constexpr size_t buffer_size = size_t{1} << 16;
+
+    private:
+        void read_all_(std::byte *data, size_t n) {
+            read_some_(data, n, n);
+        }
+
+        // Reads at least `required` and at most `limit` bytes, returns how many were read.
+        size_t read_some_(std::byte *data, size_t limit, size_t required) {
+            size_t total = 0;
+            while (total < required) {
+                const ssize_t got = ::read(fd_, data + total, std::min(limit - total, max_chunk_));
+                if (got < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    throw std::system_error(errno, std::generic_category(), "read");
+                }
+                if (got == 0) {
+                    throw std::runtime_error("Unexpected end of input");
+                }
+                total += static_cast<size_t>(got);
+            }
+            return total;
+        }
+
+        static constexpr size_t max_chunk_ = size_t{1} << 30;
+
+        int fd_;
+        std::unique_ptr<std::byte[]> buffer_;
+        size_t begin_ = 0;
+        size_t end_ = 0;
+    };
+
+    class stream_sink {
+    public:
+        explicit stream_sink(std::ostream &os) : os_(os) {}
+
+        void write(const void *data, size_t n) {
+            if (!os_.write(static_cast<const char *>(data), static_cast<std::streamsize>(n))) {
+                throw std::ios_base::failure("Stream write failed");
+            }
+        }
+
+    private:
+        std::ostream &os_;
+    };
+
+    class stream_source {
+    public:
+        explicit stream_source(std::istream &is) : is_(is) {}
+
+        void read(void *data, size_t n) {
+            if (!is_.read(static_cast<char *>(data), static_cast<std::streamsize>(n))) {
+                throw std::runtime_error("Unexpected end of input");
+            }
+        }
+
+    private:
+        std::istream &is_;
+    };
+
+    template<typename Sink, typename T>
+    void write_value(Sink &sink, const T &value) {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            sink.write(std::addressof(value), sizeof(T));
+        } else {
+            serializer<T>::write(sink, value);
+        }
+    }
+
+    template<typename T, typename Source>
+    T read_value(Source &source) {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            std::array<std::byte, sizeof(T)> bytes;
+            source.read(bytes.data(), sizeof(T));
+            return std::bit_cast<T>(bytes);
+        } else {
+            return serializer<T>::read(source);
+        }
+    }
+
+    template<typename CharT, typename Traits, typename Allocator>
+    struct serializer<std::basic_string<CharT, Traits, Allocator>> {
+        using string_type = std::basic_string<CharT, Traits, Allocator>;
+
+        template<typename Sink>
+        static void write(Sink &sink, const string_type &value) {
+            write_value(sink, static_cast<uint64_t>(value.size()));
+            sink.write(value.data(), value.size() * sizeof(CharT));
+        }
+
+        template<typename Source>
+        static string_type read(Source &source) {
+            string_type value(read_value<uint64_t>(source), CharT());
+            source.read(value.data(), value.size() * sizeof(CharT));
+            return value;
+        }
+    };
+
+    template<typename T, typename Allocator, typename GrowthPolicy>
+    struct serializer<vector<T, Allocator, GrowthPolicy>> {
+        using vector_type = vector<T, Allocator, GrowthPolicy>;
+
+        template<typename Sink>
+        static void write(Sink &sink, const vector_type &value) {
+            write_value(sink, static_cast<uint64_t>(value.size()));
+            write_elements(sink, value);
+        }
+
+        template<typename Source>
+        static vector_type read(Source &source) {
+            vector_type value;
+            read_elements(source, value, read_value<uint64_t>(source));
+            return value;
+        }
+
+        template<typename Sink>
+        static void write_elements(Sink &sink, const vector_type &value) {
+            if (value.empty()) {
+                return;
+            }
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                sink.write(&value[0], value.size() * sizeof(T));
+            } else {
+                for (const T &element: value) {
+                    write_value(sink, element);
+                }
+            }
+        }
+
+        // Elements are read straight into the vector's storage, in chunks. Capacity grows geometrically up to
+        // count, so the copying stays linear while an input that ends early has allocated at most about twice
+        // what it actually contained.
+        template<typename Source>
+        static void read_elements(Source &source, vector_type &value, size_t count) {
+            value.clear();
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                const size_t chunk = std::max<size_t>(1, read_chunk_bytes / sizeof(T));
+                for (size_t done = 0; done < count;) {
+                    const size_t n = std::min(chunk, count - done);
+                    if (done + n > value.capacity()) {
+                        value.reserve(std::min(count, std::max(done + n, 2 * value.capacity())));
+                    }
+                    value.resize_for_overwrite(done + n);
+                    source.read(&value[done], n * sizeof(T));
+                    done += n;
+                }
+            } else {
+                value.reserve(std::min<size_t>(count, read_chunk_bytes / sizeof(T) + 1));
+                for (size_t i = 0; i < count; ++i) {
+                    value.push_back(read_value<T>(source));
+                }
+            }
+        }
+
+        static constexpr size_t read_chunk_bytes = size_t{1} << 26;
+    };
+
+    template<typename Sink, typename T, typename Allocator, typename GrowthPolicy>
+    void write_vector(Sink &sink, const vector<T, Allocator, GrowthPolicy> &vec) {
+        const bool bulk = std::is_trivially_copyable_v<T>;
+        write_value(sink, serial_header{serial_header::magic_value, serial_header::current_version,
+                                        bulk ? serial_header::bulk_flag : uint16_t{0},
+                                        bulk ? sizeof(T) : 0, vec.size()});
+        serializer<vector<T, Allocator, GrowthPolicy>>::write_elements(sink, vec);
+    }
+
+    template<typename Source, typename T, typename Allocator, typename GrowthPolicy>
+    void read_vector(Source &source, vector<T, Allocator, GrowthPolicy> &vec) {
+        const bool bulk = std::is_trivially_copyable_v<T>;
+        const auto header = read_value<serial_header>(source);
+        if (header.magic != serial_header::magic_value) {
+            throw std::runtime_error("Not a serialized bmstu::vector");
+        }
+        if (header.version != serial_header::current_version) {
+            throw std::runtime_error("Unsupported serialization version " + std::to_string(header.version));
+        }
+        if (header.flags != (bulk ? serial_header::bulk_flag : 0) || header.element_size != (bulk ? sizeof(T) : 0)) {
+            throw std::runtime_error("Serialized element type does not match");
+        }
+        serializer<vector<T, Allocator, GrowthPolicy>>::read_elements(source, vec, header.count);
+    }
+
+    template<typename T, typename Allocator, typename GrowthPolicy>
+    void write_to(const vector<T, Allocator, GrowthPolicy> &vec, std::ostream &os) {
+        stream_sink sink(os);
+        write_vector(sink, vec);
+    }
+
+    template<typename T, typename Allocator, typename GrowthPolicy>
+    void write_to(const vector<T, Allocator, GrowthPolicy> &vec, int fd) {
+        fd_sink sink(fd);
+        write_vector(sink, vec);
+        sink.flush();
+    }
+
+    template<typename T, typename Allocator, typename GrowthPolicy>
+    void read_from(vector<T, Allocator, GrowthPolicy> &vec, std::istream &is) {
+        stream_source source(is);
+        read_vector(source, vec);
+    }
+
+    // Leaves fd positioned right after the vector, so vectors written back to back read back in order.
+    // Trivially copyable elements are read with exact-size reads, which works on any descriptor. Other
+    // elements are read through a buffer and the unused read-ahead is seeked back afterwards. A pipe or
+    // socket cannot seek, so if bytes past the vector were read from one, vec is filled but std::system_error
+    // with ESPIPE is thrown, because those bytes are gone from the descriptor.
+    template<typename T, typename Allocator, typename GrowthPolicy>
+    void read_from(vector<T, Allocator, GrowthPolicy> &vec, int fd) {
+        fd_source source(fd, std::is_trivially_copyable_v<T>);
+        read_vector(source, vec);
+        if (!source.unread_lookahead()) {
+            throw std::system_error(ESPIPE, std::generic_category(), "read past the vector on an unseekable fd");
+        }
+    }
+}
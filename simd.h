@@ -0,0 +1,375 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BMSTU_SIMD_X86 1
+#else
+#define BMSTU_SIMD_X86 0
+#endif
+
+namespace bmstu {
+    // Specialize for types whose operator== is exactly equality of their object representation, so whole
+    // ranges of them can be compared as bytes. Floating point is excluded because of -0.0 and NaN.
+    template<typename T>
+    struct is_bitwise_comparable
+            : std::bool_constant<std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>> {};
+
+    template<typename T>
+    inline constexpr bool is_bitwise_comparable_v = is_bitwise_comparable<T>::value;
+
+    // Kernels behind the vector comparisons and searches and the bit_vector word operations. AVX2 is
+    // chosen at run time when the CPU has it, SSE2 is the x86-64 baseline and other targets use the
+    // scalar loops.
+    namespace simd {
+        inline bool has_avx2() noexcept {
+#if BMSTU_SIMD_X86
+            static const bool supported = __builtin_cpu_supports("avx2");
+            return supported;
+#else
+            return false;
+#endif
+        }
+
+        inline bool has_popcnt() noexcept {
+#if BMSTU_SIMD_X86
+            static const bool supported = __builtin_cpu_supports("popcnt");
+            return supported;
+#else
+            return false;
+#endif
+        }
+
+        enum class word_op {
+            bit_and, bit_or, bit_xor
+        };
+
+        template<size_t Width>
+        using lane_type = std::conditional_t<Width == 1, uint8_t, std::conditional_t<Width == 2, uint16_t,
+                std::conditional_t<Width == 4, uint32_t, uint64_t>>>;
+
+        namespace detail {
+            inline size_t mismatch_scalar(const unsigned char *a, const unsigned char *b, size_t i, size_t n) noexcept {
+                for (; i < n && a[i] == b[i]; ++i) {
+                }
+                return i;
+            }
+
+            template<size_t Width>
+            size_t find_scalar(const unsigned char *p, size_t i, size_t n, lane_type<Width> value) noexcept {
+                for (; i < n; ++i) {
+                    lane_type<Width> lane;
+                    std::memcpy(&lane, p + i * Width, Width);
+                    if (lane == value) {
+                        return i;
+                    }
+                }
+                return n;
+            }
+
+            template<size_t Width>
+            size_t count_scalar(const unsigned char *p, size_t i, size_t n, lane_type<Width> value) noexcept {
+                size_t result = 0;
+                for (; i < n; ++i) {
+                    lane_type<Width> lane;
+                    std::memcpy(&lane, p + i * Width, Width);
+                    result += lane == value;
+                }
+                return result;
+            }
+
+            template<word_op Op>
+            void combine_scalar(uint64_t *dst, const uint64_t *src, size_t i, size_t n) noexcept {
+                for (; i < n; ++i) {
+                    if constexpr (Op == word_op::bit_and) {
+                        dst[i] &= src[i];
+                    } else if constexpr (Op == word_op::bit_or) {
+                        dst[i] |= src[i];
+                    } else {
+                        dst[i] ^= src[i];
+                    }
+                }
+            }
+
+            inline void invert_scalar(uint64_t *p, size_t i, size_t n) noexcept {
+                for (; i < n; ++i) {
+                    p[i] = ~p[i];
+                }
+            }
+
+            inline size_t popcount_scalar(const uint64_t *p, size_t n) noexcept {
+                size_t result = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    result += std::popcount(p[i]);
+                }
+                return result;
+            }
+
+#if BMSTU_SIMD_X86
+            __attribute__((target("avx2")))
+            inline size_t mismatch_avx2(const unsigned char *a, const unsigned char *b, size_t n) noexcept {
+                size_t i = 0;
+                for (; i + 32 <= n; i += 32) {
+                    const __m256i l = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+                    const __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+                    const auto equal = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(l, r)));
+                    if (equal != 0xFFFFFFFFu) {
+                        return i + std::countr_one(equal);
+                    }
+                }
+                return mismatch_scalar(a, b, i, n);
+            }
+
+            inline size_t mismatch_sse2(const unsigned char *a, const unsigned char *b, size_t n) noexcept {
+                size_t i = 0;
+                for (; i + 16 <= n; i += 16) {
+                    const __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+                    const __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+                    const auto equal = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(l, r)));
+                    if (equal != 0xFFFFu) {
+                        return i + std::countr_one(equal);
+                    }
+                }
+                return mismatch_scalar(a, b, i, n);
+            }
+
+            // Byte mask with every byte of each lane equal to `value` set.
+            template<size_t Width>
+            __attribute__((target("avx2")))
+            uint32_t match_mask_avx2(const unsigned char *p, lane_type<Width> value) noexcept {
+                const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+                __m256i equal;
+                if constexpr (Width == 1) {
+                    equal = _mm256_cmpeq_epi8(block, _mm256_set1_epi8(static_cast<char>(value)));
+                } else if constexpr (Width == 2) {
+                    equal = _mm256_cmpeq_epi16(block, _mm256_set1_epi16(static_cast<short>(value)));
+                } else if constexpr (Width == 4) {
+                    equal = _mm256_cmpeq_epi32(block, _mm256_set1_epi32(static_cast<int>(value)));
+                } else {
+                    equal = _mm256_cmpeq_epi64(block, _mm256_set1_epi64x(static_cast<long long>(value)));
+                }
+                return static_cast<uint32_t>(_mm256_movemask_epi8(equal));
+            }
+
+            template<size_t Width>
+            uint32_t match_mask_sse2(const unsigned char *p, lane_type<Width> value) noexcept {
+                const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+                __m128i equal;
+                if constexpr (Width == 1) {
+                    equal = _mm_cmpeq_epi8(block, _mm_set1_epi8(static_cast<char>(value)));
+                } else if constexpr (Width == 2) {
+                    equal = _mm_cmpeq_epi16(block, _mm_set1_epi16(static_cast<short>(value)));
+                } else if constexpr (Width == 4) {
+                    equal = _mm_cmpeq_epi32(block, _mm_set1_epi32(static_cast<int>(value)));
+                } else {
+                    // SSE2 has no 64-bit compare: a lane matches when both of its 32-bit halves do.
+                    const __m128i halves = _mm_cmpeq_epi32(block, _mm_set1_epi64x(static_cast<long long>(value)));
+                    equal = _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+                }
+                return static_cast<uint32_t>(_mm_movemask_epi8(equal));
+            }
+
+            template<size_t Width>
+            __attribute__((target("avx2")))
+            size_t find_avx2(const unsigned char *p, size_t n, lane_type<Width> value) noexcept {
+                constexpr size_t lanes = 32 / Width;
+                size_t i = 0;
+                for (; i + lanes <= n; i += lanes) {
+                    if (const uint32_t mask = match_mask_avx2<Width>(p + i * Width, value)) {
+                        return i + std::countr_zero(mask) / Width;
+                    }
+                }
+                return find_scalar<Width>(p, i, n, value);
+            }
+
+            template<size_t Width>
+            size_t find_sse2(const unsigned char *p, size_t n, lane_type<Width> value) noexcept {
+                constexpr size_t lanes = 16 / Width;
+                size_t i = 0;
+                for (; i + lanes <= n; i += lanes) {
+                    if (const uint32_t mask = match_mask_sse2<Width>(p + i * Width, value)) {
+                        return i + std::countr_zero(mask) / Width;
+                    }
+                }
+                return find_scalar<Width>(p, i, n, value);
+            }
+
+            template<size_t Width>
+            __attribute__((target("avx2")))
+            size_t count_avx2(const unsigned char *p, size_t n, lane_type<Width> value) noexcept {
+                constexpr size_t lanes = 32 / Width;
+                size_t result = 0;
+                size_t i = 0;
+                for (; i + lanes <= n; i += lanes) {
+                    result += std::popcount(match_mask_avx2<Width>(p + i * Width, value)) / Width;
+                }
+                return result + count_scalar<Width>(p, i, n, value);
+            }
+
+            template<size_t Width>
+            size_t count_sse2(const unsigned char *p, size_t n, lane_type<Width> value) noexcept {
+                constexpr size_t lanes = 16 / Width;
+                size_t result = 0;
+                size_t i = 0;
+                for (; i + lanes <= n; i += lanes) {
+                    result += std::popcount(match_mask_sse2<Width>(p + i * Width, value)) / Width;
+                }
+                return result + count_scalar<Width>(p, i, n, value);
+            }
+
+            template<word_op Op>
+            __attribute__((target("avx2")))
+            void combine_avx2(uint64_t *dst, const uint64_t *src, size_t n) noexcept {
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4) {
+                    const __m256i l = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + i));
+                    const __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+                    __m256i result;
+                    if constexpr (Op == word_op::bit_and) {
+                        result = _mm256_and_si256(l, r);
+                    } else if constexpr (Op == word_op::bit_or) {
+                        result = _mm256_or_si256(l, r);
+                    } else {
+                        result = _mm256_xor_si256(l, r);
+                    }
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), result);
+                }
+                combine_scalar<Op>(dst, src, i, n);
+            }
+
+            template<word_op Op>
+            void combine_sse2(uint64_t *dst, const uint64_t *src, size_t n) noexcept {
+                size_t i = 0;
+                for (; i + 2 <= n; i += 2) {
+                    const __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + i));
+                    const __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+                    __m128i result;
+                    if constexpr (Op == word_op::bit_and) {
+                        result = _mm_and_si128(l, r);
+                    } else if constexpr (Op == word_op::bit_or) {
+                        result = _mm_or_si128(l, r);
+                    } else {
+                        result = _mm_xor_si128(l, r);
+                    }
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), result);
+                }
+                combine_scalar<Op>(dst, src, i, n);
+            }
+
+            __attribute__((target("avx2")))
+            inline void invert_avx2(uint64_t *p, size_t n) noexcept {
+                const __m256i ones = _mm256_set1_epi64x(-1);
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4) {
+                    const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(p + i), _mm256_xor_si256(block, ones));
+                }
+                invert_scalar(p, i, n);
+            }
+
+            inline void invert_sse2(uint64_t *p, size_t n) noexcept {
+                const __m128i ones = _mm_set1_epi64x(-1);
+                size_t i = 0;
+                for (; i + 2 <= n; i += 2) {
+                    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(p + i), _mm_xor_si128(block, ones));
+                }
+                invert_scalar(p, i, n);
+            }
+
+            __attribute__((target("popcnt")))
+            inline size_t popcount_hw(const uint64_t *p, size_t n) noexcept {
+                size_t result = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    result += static_cast<size_t>(__builtin_popcountll(p[i]));
+                }
+                return result;
+            }
+#endif
+        }
+
+        // Index of the first differing byte, or n.
+        inline size_t mismatch_bytes(const void *a, const void *b, size_t n) noexcept {
+            const auto *l = static_cast<const unsigned char *>(a);
+            const auto *r = static_cast<const unsigned char *>(b);
+#if BMSTU_SIMD_X86
+            return has_avx2() ? detail::mismatch_avx2(l, r, n) : detail::mismatch_sse2(l, r, n);
+#else
+            return detail::mismatch_scalar(l, r, 0, n);
+#endif
+        }
+
+        template<typename T>
+        size_t mismatch(const T *a, const T *b, size_t n) noexcept {
+            static_assert(is_bitwise_comparable_v<T>);
+            return mismatch_bytes(a, b, n * sizeof(T)) / sizeof(T);
+        }
+
+        template<typename T>
+        bool equal(const T *a, const T *b, size_t n) noexcept {
+            static_assert(is_bitwise_comparable_v<T>);
+            return n == 0 || std::memcmp(a, b, n * sizeof(T)) == 0;
+        }
+
+        template<typename T>
+        inline constexpr bool has_lane_v = is_bitwise_comparable_v<T> &&
+                                           (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+        // Index of the first element equal to value, or n.
+        template<typename T>
+        size_t find(const T *first, size_t n, const T &value) noexcept {
+            static_assert(has_lane_v<T>);
+            const auto *p = reinterpret_cast<const unsigned char *>(first);
+            const auto lane = std::bit_cast<lane_type<sizeof(T)>>(value);
+#if BMSTU_SIMD_X86
+            return has_avx2() ? detail::find_avx2<sizeof(T)>(p, n, lane) : detail::find_sse2<sizeof(T)>(p, n, lane);
+#else
+            return detail::find_scalar<sizeof(T)>(p, 0, n, lane);
+#endif
+        }
+
+        template<typename T>
+        size_t count(const T *first, size_t n, const T &value) noexcept {
+            static_assert(has_lane_v<T>);
+            const auto *p = reinterpret_cast<const unsigned char *>(first);
+            const auto lane = std::bit_cast<lane_type<sizeof(T)>>(value);
+#if BMSTU_SIMD_X86
+            return has_avx2() ? detail::count_avx2<sizeof(T)>(p, n, lane) : detail::count_sse2<sizeof(T)>(p, n, lane);
+#else
+            return detail::count_scalar<sizeof(T)>(p, 0, n, lane);
+#endif
+        }
+
+        // dst[i] = dst[i] Op src[i] for every word. The ranges must not overlap unless they are the same.
+        template<word_op Op>
+        void combine(uint64_t *dst, const uint64_t *src, size_t n) noexcept {
+#if BMSTU_SIMD_X86
+            has_avx2() ? detail::combine_avx2<Op>(dst, src, n) : detail::combine_sse2<Op>(dst, src, n);
+#else
+            detail::combine_scalar<Op>(dst, src, 0, n);
+#endif
+        }
+
+        inline void invert(uint64_t *p, size_t n) noexcept {
+#if BMSTU_SIMD_X86
+            has_avx2() ? detail::invert_avx2(p, n) : detail::invert_sse2(p, n);
+#else
+            detail::invert_scalar(p, 0, n);
+#endif
+        }
+
+        // Number of set bits in n words.
+        inline size_t popcount(const uint64_t *p, size_t n) noexcept {
+#if BMSTU_SIMD_X86
+            return has_popcnt() ? detail::popcount_hw(p, n) : detail::popcount_scalar(p, n);
+#else
+            return detail::popcount_scalar(p, n);
+#endif
+        }
+    }
+}
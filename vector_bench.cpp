@@ -0,0 +1,494 @@
+#include <benchmark/benchmark.h>
+#include "bmstu_vector.h"
+#include "parallel.h"
+#include "bmstu_soa_vector.h"
+#include "bmstu_bit_vector.h"
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct Pod64 {
+    std::array<int64_t, 8> values{};
+
+    friend bool operator==(const Pod64 &l, const Pod64 &r) = default;
+
+    friend auto operator<=>(const Pod64 &l, const Pod64 &r) = default;
+};
+
+struct NonNothrowMove {
+    std::string value;
+
+    NonNothrowMove() = default;
+
+    explicit NonNothrowMove(std::string value) : value(std::move(value)) {}
+
+    NonNothrowMove(const NonNothrowMove &other) = default;
+
+    NonNothrowMove(NonNothrowMove &&other) noexcept(false) : value(std::move(other.value)) {}
+
+    NonNothrowMove &operator=(const NonNothrowMove &other) = default;
+
+    NonNothrowMove &operator=(NonNothrowMove &&other) noexcept(false) {
+        value = std::move(other.value);
+        return *this;
+    }
+
+    friend bool operator==(const NonNothrowMove &l, const NonNothrowMove &r) = default;
+
+    friend auto operator<=>(const NonNothrowMove &l, const NonNothrowMove &r) = default;
+};
+
+using MoveOnly = std::unique_ptr<int>;
+
+template<typename T>
+T make_value(size_t i) {
+    if constexpr (std::is_same_v<T, int>) {
+        return static_cast<int>(i);
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        return "benchmark value #" + std::to_string(i);
+    } else if constexpr (std::is_same_v<T, Pod64>) {
+        Pod64 pod;
+        pod.values.fill(static_cast<int64_t>(i));
+        return pod;
+    } else if constexpr (std::is_same_v<T, MoveOnly>) {
+        return std::make_unique<int>(static_cast<int>(i));
+    } else {
+        return NonNothrowMove(std::to_string(i));
+    }
+}
+
+template<typename T>
+int64_t key(const T &value) {
+    if constexpr (std::is_same_v<T, int>) {
+        return value;
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        return static_cast<int64_t>(value.size());
+    } else if constexpr (std::is_same_v<T, Pod64>) {
+        return value.values[0];
+    } else if constexpr (std::is_same_v<T, MoveOnly>) {
+        return value ? *value : 0;
+    } else {
+        return static_cast<int64_t>(value.value.size());
+    }
+}
+
+template<typename Vec>
+Vec make_filled(size_t n) {
+    Vec vec;
+    vec.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        vec.push_back(make_value<typename Vec::value_type>(i));
+    }
+    return vec;
+}
+
+template<typename Vec>
+void BM_PushBack(benchmark::State &state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    for (auto _: state) {
+        Vec vec;
+        for (size_t i = 0; i < n; ++i) {
+            vec.push_back(make_value<typename Vec::value_type>(i));
+        }
+        benchmark::DoNotOptimize(vec);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+template<typename Vec>
+void BM_PushBackReserved(benchmark::State &state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    for (auto _: state) {
+        Vec vec;
+        vec.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            vec.push_back(make_value<typename Vec::value_type>(i));
+        }
+        benchmark::DoNotOptimize(vec);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+template<typename Vec>
+void BM_EmplaceBack(benchmark::State &state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    for (auto _: state) {
+        Vec vec;
+        for (size_t i = 0; i < n; ++i) {
+            vec.emplace_back(make_value<typename Vec::value_type>(i));
+        }
+        benchmark::DoNotOptimize(vec);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+template<typename Vec>
+void BM_Resize(benchmark::State &state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    for (auto _: state) {
+        Vec vec;
+        vec.resize(n);
+        benchmark::DoNotOptimize(vec);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+template<typename Vec>
+void BM_Reserve(benchmark::State &state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    for (auto _: state) {
+        state.PauseTiming();
+        Vec vec = make_filled<Vec>(n);
+        state.ResumeTiming();
+        vec.reserve(2 * n);
+        benchmark::DoNotOptimize(vec);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+template<typename Vec>
+void BM_EmplaceMiddle(benchmark::State &state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    Vec vec = make_filled<Vec>(n);
+    for (auto _: state) {
+        vec.emplace(vec.begin() + vec.size() / 2, make_value<typename Vec::value_type>(0));
+        vec.pop_back();
+    }
+    state.SetItemsProcessed(state.iterations() * n / 2);
+}
+
+template<typename Vec>
+void BM_EraseMiddle(benchmark::State &state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    Vec vec = make_filled<Vec>(n);
+    for (auto _: state) {
+        vec.erase(vec.begin() + vec.size() / 2);
+        vec.push_back(make_value<typename Vec::value_type>(0));
+    }
+    state.SetItemsProcessed(state.iterations() * n / 2);
+}
+
+template<typename Vec>
+void BM_InsertRange(benchmark::State &state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    const Vec block = make_filled<Vec>(n);
+    for (auto _: state) {
+        Vec vec = make_filled<Vec>(0);
+        vec.insert(vec.end(), block.begin(), block.end());
+        vec.insert(vec.begin() + vec.size() / 2, block.begin(), block.end());
+        benchmark::DoNotOptimize(vec);
+    }
+    state.SetItemsProcessed(state.iterations() * n * 2);
+}
+
+template<typename Vec>
+void BM_CopyConstruct(benchmark::State &state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    Vec source = make_filled<Vec>(n);
+    for (auto _: state) {
+        Vec copy(source);
+        benchmark::DoNotOptimize(copy);
+    }
+    state.SetBytesProcessed(state.iterations() * n * sizeof(typename Vec::value_type));
+}
+
+template<typename Vec>
+void BM_CopyAssign(benchmark::State &state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    Vec source = make_filled<Vec>(n);
+    Vec target = make_filled<Vec>(n / 2);
+    for (auto _: state) {
+        target = source;
+        benchmark::DoNotOptimize(target);
+    }
+    state.SetBytesProcessed(state.iterations() * n * sizeof(typename Vec::value_type));
+}
+
+template<typename Vec>
+void BM_MoveConstruct(benchmark::State &state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    Vec source = make_filled<Vec>(n);
+    for (auto _: state) {
+        Vec moved(std::move(source));
+        source = std::move(moved);
+        benchmark::DoNotOptimize(source);
+    }
+}
+
+template<typename Vec>
+void BM_MoveAssign(benchmark::State &state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    Vec source = make_filled<Vec>(n);
+    Vec target;
+    for (auto _: state) {
+        target = std::move(source);
+        source = std::move(target);
+        benchmark::DoNotOptimize(source);
+    }
+}
+
+template<typename Vec>
+void BM_Iterate(benchmark::State &state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    Vec vec = make_filled<Vec>(n);
+    for (auto _: state) {
+        int64_t sum = 0;
+        for (const auto &value: vec) {
+            sum += key(value);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+template<typename Vec>
+void BM_Compare(benchmark::State &state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    Vec l = make_filled<Vec>(n);
+    Vec r = make_filled<Vec>(n);
+    for (auto _: state) {
+        bool equal = (l == r);
+        bool less = (l < r);
+        benchmark::DoNotOptimize(equal);
+        benchmark::DoNotOptimize(less);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+template<typename Vec>
+void BM_Find(benchmark::State &state) {
+    using T = typename Vec::value_type;
+    const auto n = static_cast<size_t>(state.range(0));
+    Vec vec = make_filled<Vec>(n);
+    const T needle = vec[n - 1];
+    for (auto _: state) {
+        size_t count;
+        if constexpr (requires { vec.count(needle); }) {
+            benchmark::DoNotOptimize(vec.find(needle));
+            count = vec.count(needle);
+        } else {
+            benchmark::DoNotOptimize(std::find(vec.begin(), vec.end(), needle));
+            count = std::count(vec.begin(), vec.end(), needle);
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+template<typename T>
+void BM_ParallelSort(benchmark::State &state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    bmstu::vector<T> source = make_filled<bmstu::vector<T>>(n);
+    std::reverse(source.begin(), source.end());
+    for (auto _: state) {
+        state.PauseTiming();
+        bmstu::vector<T> vec = source;
+        state.ResumeTiming();
+        bmstu::parallel::sort(vec);
+        benchmark::DoNotOptimize(vec);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+template<typename T>
+void BM_ParallelCopy(benchmark::State &state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    bmstu::vector<T> source = make_filled<bmstu::vector<T>>(n);
+    bmstu::vector<T> target;
+    for (auto _: state) {
+        bmstu::parallel::assign(target, source);
+        benchmark::DoNotOptimize(target);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+// Appends n inner vectors of 16 ints without reserving, so every outer reallocation has to move all
+// inner vectors built so far.
+template<typename Outer>
+void BM_NestedGrowth(benchmark::State &state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    for (auto _: state) {
+        Outer outer;
+        for (size_t i = 0; i < n; ++i) {
+            typename Outer::value_type inner;
+            inner.reserve(16);
+            for (int j = 0; j < 16; ++j) {
+                inner.push_back(j);
+            }
+            outer.push_back(std::move(inner));
+        }
+        benchmark::DoNotOptimize(outer);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+struct Record {
+    int64_t key;
+    Pod64 payload;
+};
+
+// Sums one field of n records, stored row-wise in a vector and column-wise in an soa_vector.
+void BM_FieldScanRows(benchmark::State &state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    bmstu::vector<Record> rows;
+    rows.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        rows.push_back(Record{static_cast<int64_t>(i), make_value<Pod64>(i)});
+    }
+    for (auto _: state) {
+        int64_t sum = 0;
+        for (const Record &record: rows) {
+            sum += record.key;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+void BM_FieldScanColumns(benchmark::State &state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    bmstu::soa_vector<int64_t, Pod64> columns;
+    columns.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        columns.emplace_back(static_cast<int64_t>(i), make_value<Pod64>(i));
+    }
+    for (auto _: state) {
+        int64_t sum = 0;
+        for (int64_t key: columns.column<0>()) {
+            sum += key;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+// ANDs two filters of n flags and counts the survivors, one byte per flag against one bit per flag.
+void BM_FilterBytes(benchmark::State &state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    bmstu::vector<bool> left(n);
+    bmstu::vector<bool> right(n);
+    for (size_t i = 0; i < n; ++i) {
+        left[i] = i % 2 == 0;
+        right[i] = i % 3 == 0;
+    }
+    for (auto _: state) {
+        bmstu::vector<bool> result(left);
+        for (size_t i = 0; i < n; ++i) {
+            result[i] = result[i] && right[i];
+        }
+        benchmark::DoNotOptimize(result.count(true));
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+void BM_FilterBits(benchmark::State &state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    bmstu::bit_vector<> left(n);
+    bmstu::bit_vector<> right(n);
+    for (size_t i = 0; i < n; ++i) {
+        left[i] = i % 2 == 0;
+        right[i] = i % 3 == 0;
+    }
+    for (auto _: state) {
+        bmstu::bit_vector<> result(left);
+        result &= right;
+        benchmark::DoNotOptimize(result.count());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+struct bench_config {
+    size_t max_size = 1000000;
+};
+
+template<typename Vec>
+void register_container(const std::string &name, const bench_config &config) {
+    using T = typename Vec::value_type;
+    auto add = [&](const std::string &op, void (*fn)(benchmark::State &), size_t max_size) {
+        auto *bench = benchmark::RegisterBenchmark((op + "<" + name + ">").c_str(), fn);
+        for (size_t n = 1; n <= max_size; n *= 10) {
+            bench->Arg(static_cast<int64_t>(n));
+        }
+    };
+    // Shifting half the vector per iteration is O(n); keep it off the largest sizes.
+    const size_t shift_max = std::min<size_t>(config.max_size, 100000);
+
+    add("PushBack", BM_PushBack<Vec>, config.max_size);
+    add("PushBackReserved", BM_PushBackReserved<Vec>, config.max_size);
+    add("EmplaceBack", BM_EmplaceBack<Vec>, config.max_size);
+    add("Resize", BM_Resize<Vec>, config.max_size);
+    add("Reserve", BM_Reserve<Vec>, config.max_size);
+    add("EmplaceMiddle", BM_EmplaceMiddle<Vec>, shift_max);
+    add("EraseMiddle", BM_EraseMiddle<Vec>, shift_max);
+    add("MoveConstruct", BM_MoveConstruct<Vec>, config.max_size);
+    add("MoveAssign", BM_MoveAssign<Vec>, config.max_size);
+    add("Iterate", BM_Iterate<Vec>, config.max_size);
+    add("Compare", BM_Compare<Vec>, config.max_size);
+    if constexpr (std::is_copy_constructible_v<T>) {
+        add("Find", BM_Find<Vec>, config.max_size);
+        add("CopyConstruct", BM_CopyConstruct<Vec>, config.max_size);
+        add("CopyAssign", BM_CopyAssign<Vec>, config.max_size);
+        add("InsertRange", BM_InsertRange<Vec>, config.max_size);
+    }
+}
+
+template<typename T>
+void register_element(const std::string &name, const bench_config &config) {
+    register_container<std::vector<T>>("std::vector<" + name + ">", config);
+    register_container<bmstu::vector<T>>("bmstu::vector<" + name + ">", config);
+}
+
+int main(int argc, char **argv) {
+    bench_config config;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--max_size=", 11) == 0) {
+            config.max_size = std::strtoull(argv[i] + 11, nullptr, 10);
+        }
+    }
+
+    register_element<int>("int", config);
+    register_element<std::string>("string", config);
+    register_element<Pod64>("pod64", config);
+    register_element<MoveOnly>("move_only", config);
+    register_element<NonNothrowMove>("non_nothrow_move", config);
+
+    register_container<bmstu::vector<Pod64, std::allocator<Pod64>, bmstu::grow_1_5x>>(
+            "bmstu::vector<pod64, grow_1_5x>", config);
+    register_container<bmstu::vector<Pod64, std::allocator<Pod64>, bmstu::grow_page_aware<>>>(
+            "bmstu::vector<pod64, grow_page_aware>", config);
+    register_container<bmstu::vector<Pod64, std::allocator<Pod64>, bmstu::grow_by_increment<1024>>>(
+            "bmstu::vector<pod64, grow_by_increment<1024>>", config);
+
+    auto add_parallel = [&](const char *name, void (*fn)(benchmark::State &)) {
+        auto *bench = benchmark::RegisterBenchmark(name, fn);
+        for (size_t n = 1; n <= config.max_size; n *= 10) {
+            bench->Arg(static_cast<int64_t>(n));
+        }
+        bench->UseRealTime();
+    };
+    add_parallel("ParallelSort<bmstu::vector<int>>", BM_ParallelSort<int>);
+    add_parallel("ParallelCopy<bmstu::vector<int>>", BM_ParallelCopy<int>);
+
+    auto add_single = [&](const char *name, void (*fn)(benchmark::State &)) {
+        auto *bench = benchmark::RegisterBenchmark(name, fn);
+        for (size_t n = 1; n <= config.max_size; n *= 10) {
+            bench->Arg(static_cast<int64_t>(n));
+        }
+    };
+    add_single("NestedGrowth<std::vector<std::vector<int>>>", BM_NestedGrowth<std::vector<std::vector<int>>>);
+    add_single("NestedGrowth<std::vector<bmstu::vector<int>>>", BM_NestedGrowth<std::vector<bmstu::vector<int>>>);
+    add_single("NestedGrowth<bmstu::vector<bmstu::vector<int>>>",
+               BM_NestedGrowth<bmstu::vector<bmstu::vector<int>>>);
+    add_single("FieldScan<bmstu::vector<record>>", BM_FieldScanRows);
+    add_single("FieldScan<bmstu::soa_vector<key, payload>>", BM_FieldScanColumns);
+    add_single("FilterAndCount<bmstu::vector<bool>>", BM_FilterBytes);
+    add_single("FilterAndCount<bmstu::bit_vector<>>", BM_FilterBits);
+
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -1,7 +1,29 @@
 #include <gtest/gtest.h>
 #include "bmstu_vector.h"
+#include "bmstu_small_vector.h"
+#include "bmstu_static_vector.h"
+#include "realloc_allocator.h"
+#include "mmap_allocator.h"
+#include "bmstu_mapped_vector.h"
+#include "serialization.h"
+#include "parallel.h"
+#include "bmstu_concurrent_vector.h"
+#include "bmstu_stable_vector.h"
+#include "bmstu_cow_vector.h"
+#include "bmstu_soa_vector.h"
+#include "bmstu_bit_vector.h"
+#include "numa_allocator.h"
 #include <string>
 #include <vector>
+#include <array>
+#include <memory_resource>
+#include <ranges>
+#include <sstream>
+#include <cstdio>
+#include <numeric>
+#include <thread>
+#include <atomic>
+#include <sched.h>
 
 struct NoDefaultConstructable {
     int value = 0;
@@ -73,8 +95,8 @@ struct NoMoveConstructable {
     }
 };
 
-template<typename T>
-void elem_check(bmstu::vector<T> &vec, const T &value = T{}) {
+template<typename T, typename Allocator, typename GrowthPolicy>
+void elem_check(bmstu::vector<T, Allocator, GrowthPolicy> &vec, const T &value = T{}) {
     for (size_t i = 0; i < vec.size(); ++i) {
         ASSERT_EQ(vec[i], value);
     }
@@ -249,13 +271,13 @@ TEST(Resize, WithoutDefaultConstructor) {
     bmstu::vector<NoDefaultConstructable> vec{NoDefaultConstructable(1), NoDefaultConstructable(2)};
     vec.resize(3);
     ASSERT_EQ(vec.size(), 3);
-    ASSERT_EQ(vec.capacity(), 3);
+    ASSERT_EQ(vec.capacity(), 4);
     ASSERT_EQ(vec[0].get_value(), 1);
     ASSERT_EQ(vec[1].get_value(), 2);
     ASSERT_EQ(vec[2].get_value(), 0);
     vec.resize(1);
     ASSERT_EQ(vec.size(), 1);
-    ASSERT_EQ(vec.capacity(), 3);
+    ASSERT_EQ(vec.capacity(), 4);
     ASSERT_EQ(vec[0].get_value(), 1);
 }
 
@@ -373,7 +395,1869 @@ TEST(Cout, Strings) {
     ASSERT_EQ("[Bebra Hunters]", output);
 }
 
+TEST(Cout, Empty) {
+    bmstu::vector<int> vec;
+    testing::internal::CaptureStdout();
+    std::cout << vec;
+    std::string output = testing::internal::GetCapturedStdout();
+    ASSERT_EQ("[]", output);
+}
+
 TEST(dahsav, hdasidas){
     bmstu::vector<int> vec{1,2,3};
     std::cout << vec;
-}
\ No newline at end of file
+}
+template<typename T>
+struct TrackingAllocator {
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::false_type;
+    using propagate_on_container_swap = std::false_type;
+
+    int id = 0;
+    std::shared_ptr<size_t> allocations = std::make_shared<size_t>(0);
+
+    TrackingAllocator() = default;
+
+    explicit TrackingAllocator(int id) : id(id) {}
+
+    template<typename U>
+    TrackingAllocator(const TrackingAllocator<U> &other) : id(other.id), allocations(other.allocations) {}
+
+    T *allocate(size_t n) {
+        ++*allocations;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T *ptr, size_t n) {
+        std::allocator<T>().deallocate(ptr, n);
+    }
+
+    friend bool operator==(const TrackingAllocator &l, const TrackingAllocator &r) {
+        return l.id == r.id;
+    }
+};
+
+TEST(Allocator, StatefulAllocatorIsUsed) {
+    TrackingAllocator<int> alloc(1);
+    bmstu::vector<int, TrackingAllocator<int>> vec(alloc);
+    for (int i = 0; i < 10; ++i) {
+        vec.push_back(i);
+    }
+    ASSERT_EQ(vec.get_allocator().id, 1);
+    ASSERT_GT(*alloc.allocations, 0);
+    ASSERT_EQ(vec[9], 9);
+}
+
+TEST(Allocator, MoveAssignEqualAllocatorsStealsBuffer) {
+    TrackingAllocator<int> alloc(1);
+    bmstu::vector<int, TrackingAllocator<int>> vec({1, 2, 3}, alloc);
+    bmstu::vector<int, TrackingAllocator<int>> other(alloc);
+    int *buffer = &vec[0];
+    size_t allocations = *alloc.allocations;
+    other = std::move(vec);
+    ASSERT_EQ(&other[0], buffer);
+    ASSERT_EQ(*alloc.allocations, allocations);
+    ASSERT_TRUE(vec.empty());
+}
+
+TEST(Allocator, MoveAssignUnequalAllocatorsMovesElements) {
+    bmstu::vector<std::string, TrackingAllocator<std::string>> vec({"a", "b", "c"},
+                                                                    TrackingAllocator<std::string>(1));
+    bmstu::vector<std::string, TrackingAllocator<std::string>> other(TrackingAllocator<std::string>(2));
+    other = std::move(vec);
+    ASSERT_EQ(other.get_allocator().id, 2);
+    ASSERT_EQ(other.size(), 3);
+    ASSERT_EQ(other[2], "c");
+    ASSERT_TRUE(vec.empty());
+}
+
+template<typename T>
+struct CopyPropagatingAllocator : TrackingAllocator<T> {
+    using propagate_on_container_copy_assignment = std::true_type;
+
+    using TrackingAllocator<T>::TrackingAllocator;
+
+    template<typename U>
+    CopyPropagatingAllocator(const CopyPropagatingAllocator<U> &other) : TrackingAllocator<T>(other) {}
+};
+
+TEST(Allocator, CopyAssignPropagatesAllocatorOnly) {
+    using allocator = CopyPropagatingAllocator<std::string>;
+    allocator target_alloc(1);
+    allocator source_alloc(2);
+    bmstu::vector<std::string, allocator> target({"x", "y"}, target_alloc);
+    bmstu::vector<std::string, allocator> source({"a", "b", "c"}, source_alloc);
+    const size_t source_allocations = *source_alloc.allocations;
+    target = source;
+    ASSERT_EQ(target.get_allocator().id, 2);
+    ASSERT_TRUE(target == source);
+    ASSERT_EQ(*source_alloc.allocations, source_allocations + 1);
+    for (int i = 0; i < 10; ++i) {
+        target.push_back(std::to_string(i));
+    }
+    ASSERT_GT(*source_alloc.allocations, source_allocations + 1);
+    ASSERT_EQ(target[12], "9");
+    target = target;
+    ASSERT_EQ(target.size(), 13);
+}
+
+TEST(Allocator, PmrMonotonicBuffer) {
+    std::array<std::byte, 1024> buffer{};
+    std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+    bmstu::pmr::vector<int> vec(&arena);
+    for (int i = 0; i < 32; ++i) {
+        vec.push_back(i);
+    }
+    auto *first = reinterpret_cast<std::byte *>(&vec[0]);
+    ASSERT_TRUE(first >= buffer.data() && first < buffer.data() + buffer.size());
+    bmstu::pmr::vector<int> copy(vec, &arena);
+    ASSERT_TRUE(copy == vec);
+}
+
+struct alignas(128) OverAligned {
+    int value = 0;
+};
+
+TEST(Allocator, AlignedBuffersStayAligned) {
+    static_assert(bmstu::raw_memory<float, bmstu::aligned_allocator<float, 64>>::alignment == 64);
+    static_assert(bmstu::raw_memory<float>::alignment == alignof(float));
+    using rebound = std::allocator_traits<bmstu::aligned_allocator<char, 32>>::rebind_alloc<OverAligned>;
+    static_assert(rebound::alignment == 128);
+    bmstu::aligned_vector<float> vec;
+    for (int i = 0; i < 1000; ++i) {
+        vec.push_back(static_cast<float>(i));
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(vec.data()) % bmstu::cache_line_size, 0);
+    }
+    vec.shrink_to(10);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(vec.data()) % bmstu::cache_line_size, 0);
+    ASSERT_EQ(vec.data()[999], 999.0f);
+    bmstu::aligned_vector<float, 32> copy(vec.begin(), vec.end());
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(copy.data()) % 32, 0);
+    ASSERT_EQ(copy.size(), 1000);
+}
+
+TEST(Allocator, OverAlignedElements) {
+    bmstu::vector<OverAligned> vec;
+    bmstu::vector<OverAligned, bmstu::aligned_allocator<OverAligned, 256>> wider;
+    for (int i = 0; i < 50; ++i) {
+        vec.push_back(OverAligned{i});
+        wider.push_back(OverAligned{i});
+    }
+    for (int i = 0; i < 50; ++i) {
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(&vec[i]) % 128, 0);
+        ASSERT_EQ(vec[i].value, i);
+    }
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(wider.data()) % 256, 0);
+}
+
+struct Relocatable {
+    static inline int destructions = 0;
+
+    explicit Relocatable(int value) : value(std::make_unique<int>(value)) {}
+
+    Relocatable(Relocatable &&other) noexcept = default;
+
+    Relocatable &operator=(Relocatable &&other) noexcept = default;
+
+    ~Relocatable() {
+        ++destructions;
+    }
+
+    std::unique_ptr<int> value;
+};
+
+template<>
+struct bmstu::is_trivially_relocatable<Relocatable> : std::true_type {};
+
+TEST(Relocation, Traits) {
+    static_assert(bmstu::is_trivially_relocatable_v<int>);
+    static_assert(bmstu::is_trivially_relocatable_v<std::unique_ptr<int>>);
+    static_assert(bmstu::is_trivially_relocatable_v<Relocatable>);
+    static_assert(!bmstu::is_trivially_relocatable_v<NoMoveConstructable>);
+}
+
+TEST(Relocation, GrowthSkipsDestructors) {
+    Relocatable::destructions = 0;
+    {
+        bmstu::vector<Relocatable> vec;
+        for (int i = 0; i < 100; ++i) {
+            vec.emplace_back(i);
+        }
+        ASSERT_EQ(Relocatable::destructions, 0);
+        for (int i = 0; i < 100; ++i) {
+            ASSERT_EQ(*vec[i].value, i);
+        }
+    }
+    ASSERT_EQ(Relocatable::destructions, 100);
+}
+
+TEST(Relocation, EmplaceAndEraseShiftTail) {
+    bmstu::vector<std::unique_ptr<int>> vec;
+    vec.reserve(8);
+    for (int i = 0; i < 5; ++i) {
+        vec.emplace_back(std::make_unique<int>(i));
+    }
+    vec.emplace(vec.begin() + 2, std::make_unique<int>(42));
+    ASSERT_EQ(vec.size(), 6);
+    ASSERT_EQ(*vec[2], 42);
+    ASSERT_EQ(*vec[3], 2);
+    ASSERT_EQ(*vec[5], 4);
+    vec.erase(vec.begin() + 1);
+    ASSERT_EQ(vec.size(), 5);
+    ASSERT_EQ(*vec[1], 42);
+    ASSERT_EQ(*vec[4], 4);
+}
+
+struct ThrowingCopy {
+    static inline int copies_left = -1;
+
+    explicit ThrowingCopy(int value) : value(value) {}
+
+    ThrowingCopy(const ThrowingCopy &other) : value(other.value) {
+        if (copies_left >= 0 && copies_left-- == 0) {
+            throw std::runtime_error("copy failed");
+        }
+    }
+
+    ThrowingCopy &operator=(const ThrowingCopy &other) {
+        if (copies_left >= 0 && copies_left-- == 0) {
+            throw std::runtime_error("copy failed");
+        }
+        value = other.value;
+        return *this;
+    }
+
+    int value;
+};
+
+TEST(Noexcept, Specifications) {
+    using tracked = bmstu::vector<int, TrackingAllocator<int>>;
+    static_assert(std::is_nothrow_move_constructible_v<bmstu::raw_memory<std::string>>);
+    static_assert(std::is_nothrow_move_constructible_v<bmstu::vector<std::string>>);
+    static_assert(std::is_nothrow_move_assignable_v<bmstu::vector<std::string>>);
+    static_assert(std::is_nothrow_move_assignable_v<bmstu::pmr::vector<int>> ==
+                  std::allocator_traits<std::pmr::polymorphic_allocator<int>>::is_always_equal::value);
+    static_assert(!std::is_nothrow_move_assignable_v<tracked>);
+    static_assert(std::is_nothrow_move_assignable_v<bmstu::small_vector<std::string, 4>>);
+    static_assert(!std::is_nothrow_move_assignable_v<bmstu::small_vector<int, 4, TrackingAllocator<int>>>);
+    static_assert(!std::is_nothrow_copy_assignable_v<bmstu::vector<int>>);
+    static_assert(std::is_nothrow_swappable_v<bmstu::vector<std::string>>);
+    static_assert(bmstu::is_trivially_relocatable_v<bmstu::vector<std::string>>);
+    static_assert(bmstu::is_trivially_relocatable_v<bmstu::pmr::vector<int>>);
+    static_assert(!bmstu::is_trivially_relocatable_v<tracked>);
+}
+
+TEST(Noexcept, CopyAssignReusesBufferAndAssignStrongKeepsContents) {
+    bmstu::vector<ThrowingCopy> source;
+    bmstu::vector<ThrowingCopy> target;
+    for (int i = 0; i < 4; ++i) {
+        source.emplace_back(i);
+        target.emplace_back(10 + i);
+    }
+    target.reserve(16);
+    ThrowingCopy *buffer = &target[0];
+    target = source;
+    ASSERT_EQ(&target[0], buffer);
+    ASSERT_EQ(target[3].value, 3);
+    for (int i = 0; i < 4; ++i) {
+        target[i].value = 10 + i;
+    }
+    ThrowingCopy::copies_left = 2;
+    ASSERT_THROW(target.assign_strong(source), std::runtime_error);
+    ThrowingCopy::copies_left = -1;
+    ASSERT_EQ(target.size(), 4);
+    ASSERT_EQ(&target[0], buffer);
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_EQ(target[i].value, 10 + i);
+    }
+    target.assign_strong(source);
+    ASSERT_EQ(target[3].value, 3);
+    ThrowingCopy::copies_left = 2;
+    ASSERT_THROW(target = source, std::runtime_error);
+    ThrowingCopy::copies_left = -1;
+    ASSERT_EQ(target.size(), 4);
+}
+
+struct LiveThrowingCopy : ThrowingCopy {
+    static inline int live = 0;
+
+    explicit LiveThrowingCopy(int value) : ThrowingCopy(value) {
+        ++live;
+    }
+
+    LiveThrowingCopy(const LiveThrowingCopy &other) : ThrowingCopy(other) {
+        ++live;
+    }
+
+    LiveThrowingCopy(LiveThrowingCopy &&other) noexcept : ThrowingCopy(other.value) {
+        ++live;
+    }
+
+    LiveThrowingCopy &operator=(const LiveThrowingCopy &other) = default;
+
+    LiveThrowingCopy &operator=(LiveThrowingCopy &&other) noexcept {
+        value = other.value;
+        return *this;
+    }
+
+    ~LiveThrowingCopy() {
+        --live;
+    }
+};
+
+// A copy that throws after the tail has been moved past the old end must not orphan the elements built there.
+TEST(Noexcept, InsertInPlaceKeepsBuiltTail) {
+    static_assert(!bmstu::is_trivially_relocatable_v<LiveThrowingCopy>);
+    const LiveThrowingCopy value(-1);
+    for (auto [index, count, copies]: {std::array<size_t, 3>{1, 2, 2}, std::array<size_t, 3>{5, 3, 3}}) {
+        {
+            bmstu::vector<LiveThrowingCopy> vec;
+            vec.reserve(16);
+            for (int i = 0; i < 6; ++i) {
+                vec.emplace_back(i);
+            }
+            ThrowingCopy::copies_left = static_cast<int>(copies);
+            ASSERT_THROW(vec.insert(vec.begin() + index, count, value), std::runtime_error);
+            ThrowingCopy::copies_left = -1;
+            ASSERT_EQ(LiveThrowingCopy::live, vec.size() + 1);
+            ASSERT_GE(vec.size(), 6);
+            ASSERT_EQ(vec[0].value, 0);
+        }
+        ASSERT_EQ(LiveThrowingCopy::live, 1);
+    }
+}
+
+template<typename Outer>
+void expect_inner_buffers_move(Outer &outer) {
+    std::vector<const void *> buffers;
+    for (int i = 0; i < 64; ++i) {
+        outer.emplace_back();
+        outer[outer.size() - 1].push_back(i);
+        buffers.push_back(&outer[outer.size() - 1][0]);
+    }
+    for (int i = 0; i < 64; ++i) {
+        ASSERT_EQ(static_cast<const void *>(&outer[i][0]), buffers[i]);
+        ASSERT_EQ(outer[i][0], i);
+    }
+}
+
+TEST(Noexcept, NestedGrowthMovesInnerBuffers) {
+    bmstu::vector<bmstu::vector<int>> nested;
+    expect_inner_buffers_move(nested);
+    std::vector<bmstu::vector<int>> std_outer;
+    expect_inner_buffers_move(std_outer);
+    bmstu::vector<bmstu::vector<int, TrackingAllocator<int>>> tracked;
+    expect_inner_buffers_move(tracked);
+    std::vector<bmstu::vector<int, TrackingAllocator<int>>> std_tracked;
+    expect_inner_buffers_move(std_tracked);
+}
+
+TEST(Realloc, GrowthKeepsContents) {
+    static_assert(bmstu::raw_memory<int, bmstu::realloc_allocator<int>>::can_reallocate);
+    static_assert(!bmstu::raw_memory<std::string, bmstu::realloc_allocator<std::string>>::can_reallocate);
+    bmstu::vector<int, bmstu::realloc_allocator<int>> vec;
+    for (int i = 0; i < 100000; ++i) {
+        vec.push_back(i);
+    }
+    vec.emplace(vec.begin(), -1);
+    vec.reserve(1 << 20);
+    ASSERT_EQ(vec.capacity(), 1 << 20);
+    ASSERT_EQ(vec.size(), 100001);
+    ASSERT_EQ(vec[0], -1);
+    for (int i = 0; i < 100000; ++i) {
+        ASSERT_EQ(vec[i + 1], i);
+    }
+}
+
+TEST(Realloc, PushBackOwnElement) {
+    bmstu::vector<int, bmstu::realloc_allocator<int>> vec{7};
+    for (int i = 0; i < 10; ++i) {
+        vec.push_back(vec[0]);
+    }
+    elem_check(vec, 7);
+}
+
+TEST(Realloc, NonRelocatableFallsBackToCopy) {
+    bmstu::vector<std::string, bmstu::realloc_allocator<std::string>> vec;
+    for (int i = 0; i < 100; ++i) {
+        vec.push_back(std::string(32, 'a' + i % 26));
+    }
+    ASSERT_EQ(vec[99], std::string(32, 'a' + 99 % 26));
+}
+
+TEST(GrowthPolicy, Factors) {
+    bmstu::vector<int, std::allocator<int>, bmstu::grow_1_5x> vec;
+    std::vector<size_t> capacities;
+    for (int i = 0; i < 10; ++i) {
+        vec.push_back(i);
+        if (capacities.empty() || capacities.back() != vec.capacity()) {
+            capacities.push_back(vec.capacity());
+        }
+    }
+    ASSERT_EQ(capacities, (std::vector<size_t>{1, 2, 3, 4, 6, 9, 13}));
+    bmstu::vector<int> doubling;
+    for (int i = 0; i < 5; ++i) {
+        doubling.push_back(i);
+    }
+    ASSERT_EQ(doubling.capacity(), 8);
+}
+
+TEST(GrowthPolicy, FixedIncrement) {
+    bmstu::vector<int, std::allocator<int>, bmstu::grow_by_increment<16>> vec;
+    vec.push_back(1);
+    ASSERT_EQ(vec.capacity(), 16);
+    for (int i = 0; i < 16; ++i) {
+        vec.push_back(i);
+    }
+    ASSERT_EQ(vec.capacity(), 32);
+    vec.emplace(vec.begin(), 0);
+    ASSERT_EQ(vec.size(), 18);
+}
+
+template<typename Vector>
+std::vector<size_t> capacities_of_resize_by_one(Vector &vec, size_t n) {
+    std::vector<size_t> capacities;
+    for (size_t i = 0; i < n; ++i) {
+        vec.resize(vec.size() + 1);
+        if (capacities.empty() || capacities.back() != vec.capacity()) {
+            capacities.push_back(vec.capacity());
+        }
+    }
+    return capacities;
+}
+
+TEST(GrowthPolicy, ResizeFollowsPolicy) {
+    bmstu::vector<int, std::allocator<int>, bmstu::grow_1_5x> vec;
+    ASSERT_EQ(capacities_of_resize_by_one(vec, 10), (std::vector<size_t>{1, 2, 3, 4, 6, 9, 13}));
+    bmstu::vector<int> doubling;
+    ASSERT_EQ(capacities_of_resize_by_one(doubling, 1000).size(), 11);
+    ASSERT_EQ(doubling.capacity(), 1024);
+    doubling.resize_for_overwrite(1025);
+    ASSERT_EQ(doubling.capacity(), 2048);
+    bmstu::small_vector<int, 4> small;
+    ASSERT_EQ(capacities_of_resize_by_one(small, 100).back(), 128);
+}
+
+TEST(GrowthPolicy, PageAware) {
+    using policy = bmstu::grow_page_aware<>;
+    ASSERT_EQ(policy::next_capacity(0, 1, sizeof(int)), 4);
+    ASSERT_EQ(policy::next_capacity(1000, 1001, sizeof(int)), 2048);
+    ASSERT_EQ(policy::next_capacity(1100, 1101, sizeof(int)), 3072);
+    bmstu::vector<int, bmstu::realloc_allocator<int>, policy> vec;
+    for (int i = 0; i < 1000; ++i) {
+        vec.push_back(i);
+    }
+    ASSERT_GE(vec.capacity(), 1000);
+    ASSERT_EQ(vec.capacity() * sizeof(int), malloc_usable_size(&vec[0]));
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_EQ(vec[i], i);
+    }
+}
+
+template<typename Container>
+class ContainerApi : public testing::Test {
+protected:
+    using value_type = typename Container::value_type;
+
+    static value_type make(int i) {
+        if constexpr (std::is_same_v<value_type, std::string>) {
+            return "value " + std::to_string(i);
+        } else {
+            return value_type(i);
+        }
+    }
+
+    static Container make_range(int n) {
+        Container vec;
+        for (int i = 0; i < n; ++i) {
+            vec.push_back(make(i));
+        }
+        return vec;
+    }
+
+    static void check_range(const Container &vec, int n) {
+        ASSERT_EQ(vec.size(), n);
+        for (int i = 0; i < n; ++i) {
+            ASSERT_EQ(vec[i], make(i));
+        }
+    }
+};
+
+using ContainerTypes = testing::Types<bmstu::vector<int>, bmstu::vector<std::string>,
+        bmstu::small_vector<int, 4>, bmstu::small_vector<std::string, 4>,
+        bmstu::static_vector<int, 128>, bmstu::static_vector<std::string, 128>,
+        bmstu::stable_vector<int, 4>, bmstu::stable_vector<std::string, 4>>;
+TYPED_TEST_SUITE(ContainerApi, ContainerTypes);
+
+TYPED_TEST(ContainerApi, PushBackAndIndex) {
+    for (int n: {0, 1, 3, 4, 5, 100}) {
+        this->check_range(this->make_range(n), n);
+    }
+}
+
+TYPED_TEST(ContainerApi, InitializerList) {
+    TypeParam vec{this->make(0), this->make(1), this->make(2)};
+    this->check_range(vec, 3);
+    ASSERT_THROW(vec.at(3), std::out_of_range);
+}
+
+TYPED_TEST(ContainerApi, CopyAndMove) {
+    for (int n: {2, 10}) {
+        TypeParam vec = this->make_range(n);
+        TypeParam copy(vec);
+        ASSERT_TRUE(copy == vec);
+        TypeParam moved(std::move(copy));
+        this->check_range(moved, n);
+        ASSERT_TRUE(copy.empty());
+        TypeParam assigned = this->make_range(3);
+        assigned = vec;
+        this->check_range(assigned, n);
+        assigned = this->make_range(1);
+        this->check_range(assigned, 1);
+        swap(assigned, moved);
+        this->check_range(assigned, n);
+        this->check_range(moved, 1);
+    }
+}
+
+TYPED_TEST(ContainerApi, EmplaceAndErase) {
+    TypeParam vec = this->make_range(4);
+    vec.emplace(vec.begin() + 1, this->make(42));
+    vec.incert(vec.begin(), this->make(7));
+    ASSERT_EQ(vec.size(), 6);
+    ASSERT_EQ(vec[0], this->make(7));
+    ASSERT_EQ(vec[1], this->make(0));
+    ASSERT_EQ(vec[2], this->make(42));
+    ASSERT_EQ(vec[5], this->make(3));
+    vec.erase(vec.begin());
+    vec.erase(vec.begin() + 1);
+    this->check_range(vec, 4);
+}
+
+TYPED_TEST(ContainerApi, ResizeReserveClear) {
+    TypeParam vec = this->make_range(3);
+    vec.reserve(50);
+    ASSERT_GE(vec.capacity(), 50);
+    this->check_range(vec, 3);
+    vec.resize(10);
+    ASSERT_EQ(vec.size(), 10);
+    ASSERT_EQ(vec[9], typename TypeParam::value_type{});
+    vec.resize(2);
+    this->check_range(vec, 2);
+    vec.pop_back();
+    this->check_range(vec, 1);
+    vec.clear();
+    ASSERT_TRUE(vec.empty());
+}
+
+TYPED_TEST(ContainerApi, Comparison) {
+    TypeParam a = this->make_range(3);
+    TypeParam b = this->make_range(4);
+    ASSERT_TRUE(a < b);
+    ASSERT_TRUE(b > a);
+    ASSERT_TRUE(a <= a);
+    ASSERT_TRUE(a != b);
+    b.pop_back();
+    ASSERT_TRUE(a == b);
+}
+
+TEST(SmallVector, StaysInlineUntilOverflow) {
+    bmstu::small_vector<int, 8> vec;
+    for (int i = 0; i < 8; ++i) {
+        vec.push_back(i);
+    }
+    ASSERT_TRUE(vec.is_inline());
+    ASSERT_EQ(vec.capacity(), 8);
+    vec.push_back(8);
+    ASSERT_FALSE(vec.is_inline());
+    ASSERT_EQ(vec.capacity(), 16);
+    ASSERT_EQ(vec[8], 8);
+}
+
+TEST(SmallVector, MoveStealsHeapBuffer) {
+    bmstu::small_vector<std::string, 2> vec{"a", "b", "c"};
+    const std::string *buffer = &vec[0];
+    bmstu::small_vector<std::string, 2> moved(std::move(vec));
+    ASSERT_EQ(&moved[0], buffer);
+    ASSERT_TRUE(vec.is_inline());
+    ASSERT_TRUE(vec.empty());
+}
+
+constexpr bmstu::static_vector<int, 16> squares_table() {
+    bmstu::static_vector<int, 16> table;
+    for (int i = 0; i < 10; ++i) {
+        table.push_back(i * i);
+    }
+    table.erase(table.begin());
+    table.emplace(table.begin(), -1);
+    return table;
+}
+
+TEST(StaticVector, ConstexprTable) {
+    constexpr auto table = squares_table();
+    static_assert(table.size() == 10);
+    static_assert(table[0] == -1 && table[9] == 81);
+    static_assert(bmstu::static_vector<int, 4>{1, 2} < bmstu::static_vector<int, 4>{1, 3});
+    ASSERT_EQ(table.capacity(), 16);
+}
+
+TEST(StaticVector, OverflowPolicies) {
+    bmstu::static_vector<std::string, 2> vec{"a", "b"};
+    ASSERT_TRUE(vec.full());
+    ASSERT_THROW(vec.push_back("c"), std::length_error);
+    ASSERT_FALSE(vec.try_push_back("c"));
+    vec.pop_back();
+    ASSERT_TRUE(vec.try_push_back("c"));
+    ASSERT_EQ(vec[1], "c");
+    bmstu::static_vector<int, 2, bmstu::assert_on_overflow> checked;
+    ASSERT_TRUE(checked.try_push_back(1));
+    ASSERT_DEATH(checked.resize(3), "");
+}
+
+TEST(StaticVector, AssertOnOverflowStopsInEveryBuild) {
+    bmstu::static_vector<std::string, 2, bmstu::assert_on_overflow> full{"a", "b"};
+    ASSERT_DEATH(full.emplace_back("c"), "");
+    ASSERT_DEATH(full.incert(full.begin(), std::string("c")), "");
+    ASSERT_DEATH(full.resize(3), "");
+    ASSERT_EQ(full.size(), 2);
+}
+
+TEST(BulkInsert, IteratorRange) {
+    static_assert(std::contiguous_iterator<bmstu::vector<int>::iterator>);
+    bmstu::vector<int> vec{1, 2, 3, 4};
+    std::vector<int> source{10, 11, 12};
+    vec.insert(vec.begin() + 1, source.begin(), source.end());
+    ASSERT_TRUE(vec == (bmstu::vector<int>{1, 10, 11, 12, 2, 3, 4}));
+    vec.reserve(20);
+    vec.insert(vec.end() - 1, source.begin(), source.end());
+    ASSERT_TRUE(vec == (bmstu::vector<int>{1, 10, 11, 12, 2, 3, 10, 11, 12, 4}));
+}
+
+TEST(BulkInsert, StringsInPlace) {
+    bmstu::vector<std::string> vec{"a", "b", "c", "d"};
+    vec.reserve(16);
+    vec.insert(vec.begin() + 3, {"x", "y"});
+    ASSERT_TRUE(vec == (bmstu::vector<std::string>{"a", "b", "c", "x", "y", "d"}));
+    vec.insert(vec.begin() + 1, 2, std::string("z"));
+    ASSERT_TRUE(vec == (bmstu::vector<std::string>{"a", "z", "z", "b", "c", "x", "y", "d"}));
+    vec.insert(vec.begin(), vec.begin() + 5, vec.end());
+    ASSERT_TRUE(vec == (bmstu::vector<std::string>{"x", "y", "d", "a", "z", "z", "b", "c", "x", "y", "d"}));
+}
+
+TEST(BulkInsert, CountCopiesOwnElement) {
+    bmstu::vector<int> vec{5, 6};
+    vec.insert(vec.begin(), 3, vec[1]);
+    ASSERT_TRUE(vec == (bmstu::vector<int>{6, 6, 6, 5, 6}));
+}
+
+TEST(BulkInsert, InputIterators) {
+    std::istringstream input("7 8 9");
+    bmstu::vector<int> vec{1, 2};
+    vec.insert(vec.begin() + 1, std::istream_iterator<int>(input), std::istream_iterator<int>());
+    ASSERT_TRUE(vec == (bmstu::vector<int>{1, 7, 8, 9, 2}));
+}
+
+TEST(BulkInsert, Ranges) {
+    bmstu::vector<int> vec;
+    vec.append_range(std::views::iota(0, 5));
+    vec.insert_range(vec.begin() + 2, std::vector<int>{100, 101});
+    ASSERT_TRUE(vec == (bmstu::vector<int>{0, 1, 100, 101, 2, 3, 4}));
+    vec.assign_range(std::views::iota(0, 3) | std::views::transform([](int i) { return i * 2; }));
+    ASSERT_TRUE(vec == (bmstu::vector<int>{0, 2, 4}));
+}
+
+TEST(BulkInsert, Assign) {
+    bmstu::vector<std::string> vec{"a", "b", "c"};
+    std::vector<std::string> longer{"1", "2", "3", "4", "5"};
+    vec.assign(longer.begin(), longer.end());
+    ASSERT_EQ(vec.size(), 5);
+    ASSERT_EQ(vec[4], "5");
+    vec.assign(2, "q");
+    ASSERT_TRUE(vec == (bmstu::vector<std::string>{"q", "q"}));
+    vec.assign({"x", "y", "z"});
+    ASSERT_TRUE(vec == (bmstu::vector<std::string>{"x", "y", "z"}));
+    bmstu::vector<std::string> constructed(longer.begin() + 1, longer.end());
+    ASSERT_EQ(constructed.size(), 4);
+    ASSERT_EQ(constructed[0], "2");
+}
+
+TEST(RangeErase, ErasesRange) {
+    bmstu::vector<std::string> vec{"a", "b", "c", "d", "e"};
+    auto it = vec.erase(vec.begin() + 1, vec.begin() + 3);
+    ASSERT_EQ(*it, "d");
+    ASSERT_TRUE(vec == (bmstu::vector<std::string>{"a", "d", "e"}));
+    vec.erase(vec.begin(), vec.begin());
+    ASSERT_EQ(vec.size(), 3);
+    vec.erase(vec.begin(), vec.end());
+    ASSERT_TRUE(vec.empty());
+    bmstu::vector<int> ints{1, 2, 3, 4, 5};
+    ints.erase(ints.begin() + 3, ints.end());
+    ASSERT_TRUE(ints == (bmstu::vector<int>{1, 2, 3}));
+}
+
+TEST(RangeErase, EraseIf) {
+    bmstu::vector<int> vec;
+    for (int i = 0; i < 20; ++i) {
+        vec.push_back(i);
+    }
+    ASSERT_EQ(bmstu::erase_if(vec, [](int i) { return i % 2 == 0; }), 10);
+    ASSERT_EQ(vec.size(), 10);
+    for (size_t i = 0; i < vec.size(); ++i) {
+        ASSERT_EQ(vec[i], 2 * i + 1);
+    }
+    bmstu::vector<std::string> strings{"x", "y", "x", "z"};
+    ASSERT_EQ(bmstu::erase(strings, "x"), 2);
+    ASSERT_TRUE(strings == (bmstu::vector<std::string>{"y", "z"}));
+}
+
+TEST(RangeErase, UnorderedErase) {
+    bmstu::vector<std::string> vec{"a", "b", "c", "d"};
+    auto it = vec.unordered_erase(vec.begin() + 1);
+    ASSERT_EQ(*it, "d");
+    ASSERT_TRUE(vec == (bmstu::vector<std::string>{"a", "d", "c"}));
+    vec.unordered_erase(vec.end() - 1);
+    ASSERT_TRUE(vec == (bmstu::vector<std::string>{"a", "d"}));
+    bmstu::vector<std::unique_ptr<int>> ptrs;
+    for (int i = 0; i < 3; ++i) {
+        ptrs.push_back(std::make_unique<int>(i));
+    }
+    ptrs.unordered_erase(ptrs.begin());
+    ASSERT_EQ(*ptrs[0], 2);
+    ptrs.unordered_erase(ptrs.begin() + 1);
+    ASSERT_EQ(ptrs.size(), 1);
+    ASSERT_EQ(*ptrs[0], 2);
+}
+
+struct CountedDefault {
+    static inline int constructions = 0;
+
+    CountedDefault() {
+        ++constructions;
+    }
+
+    int value = 7;
+};
+
+TEST(DefaultInit, ConstructAndResizeForOverwrite) {
+    bmstu::vector<int> vec(1000, bmstu::default_init);
+    ASSERT_EQ(vec.size(), 1000);
+    ASSERT_EQ(vec.capacity(), 1000);
+    for (size_t i = 0; i < vec.size(); ++i) {
+        vec[i] = static_cast<int>(i);
+    }
+    vec.resize_for_overwrite(10);
+    ASSERT_EQ(vec.size(), 10);
+    ASSERT_EQ(vec[9], 9);
+    int *buffer = &vec[0];
+    vec.resize_for_overwrite(500);
+    ASSERT_EQ(&vec[0], buffer);
+    ASSERT_EQ(vec.capacity(), 1000);
+    vec.resize_for_overwrite(2000);
+    ASSERT_EQ(vec.size(), 2000);
+    ASSERT_EQ(vec[9], 9);
+}
+
+TEST(DefaultInit, NonTrivialTypesAreStillConstructed) {
+    CountedDefault::constructions = 0;
+    bmstu::vector<CountedDefault> vec(5, bmstu::default_init);
+    vec.resize_for_overwrite(8);
+    ASSERT_EQ(CountedDefault::constructions, 8);
+    ASSERT_EQ(vec[7].value, 7);
+}
+
+TEST(DefaultInit, ResizeGrowsInPlace) {
+    bmstu::vector<std::string> vec{"a", "b", "c", "d"};
+    vec.resize(1);
+    std::string *buffer = &vec[0];
+    vec.resize(4);
+    ASSERT_EQ(&vec[0], buffer);
+    ASSERT_EQ(vec[0], "a");
+    ASSERT_EQ(vec[3], "");
+}
+
+TEST(Shrink, ShrinkToFit) {
+    bmstu::vector<std::string> vec;
+    for (int i = 0; i < 100; ++i) {
+        vec.push_back(std::to_string(i));
+    }
+    vec.resize(10);
+    ASSERT_EQ(vec.capacity(), 128);
+    ASSERT_EQ(vec.memory_usage(), 128 * sizeof(std::string));
+    vec.shrink_to_fit();
+    ASSERT_EQ(vec.capacity(), 10);
+    ASSERT_EQ(vec.memory_usage(), 10 * sizeof(std::string));
+    ASSERT_EQ(vec[9], "9");
+    vec.clear();
+    vec.shrink_to_fit();
+    ASSERT_EQ(vec.capacity(), 0);
+    ASSERT_EQ(vec.memory_usage(), 0);
+}
+
+TEST(Shrink, ShrinkToKeepsElements) {
+    bmstu::vector<int, bmstu::realloc_allocator<int>> vec(1000);
+    vec.resize(100);
+    vec.shrink_to(500);
+    ASSERT_EQ(vec.capacity(), 500);
+    vec.shrink_to(1);
+    ASSERT_EQ(vec.capacity(), 100);
+    vec.shrink_to(200);
+    ASSERT_EQ(vec.capacity(), 100);
+    elem_check(vec, 0);
+}
+
+TEST(Shrink, SlackThreshold) {
+    bmstu::vector<int> vec(100);
+    vec.resize(60);
+    ASSERT_FALSE(vec.shrink_if_slack_exceeds(50));
+    ASSERT_EQ(vec.capacity(), 100);
+    ASSERT_TRUE(vec.shrink_if_slack_exceeds(25));
+    ASSERT_EQ(vec.capacity(), 60);
+}
+
+TEST(MmapAllocator, GrowsAcrossThresholdAndBack) {
+    using allocator = bmstu::mmap_allocator<int, 1 << 16>;
+    static_assert(bmstu::raw_memory<int, allocator>::can_reallocate);
+    bmstu::vector<int, allocator> vec;
+    for (int i = 0; i < 1000000; ++i) {
+        vec.push_back(i);
+    }
+    ASSERT_GE(vec.capacity() * sizeof(int), allocator::threshold);
+    for (int i = 0; i < 1000000; ++i) {
+        ASSERT_EQ(vec[i], i);
+    }
+    vec.resize(100000);
+    vec.shrink_to_fit();
+    ASSERT_EQ(vec.capacity(), 100000);
+    ASSERT_EQ(vec[99999], 99999);
+    vec.resize(10);
+    vec.shrink_to_fit();
+    ASSERT_EQ(vec.capacity(), 10);
+    ASSERT_EQ(vec[9], 9);
+}
+
+TEST(MmapAllocator, LargeBlocksAreHugePageAligned) {
+    bmstu::vector<char, bmstu::mmap_allocator<char>> vec(bmstu::mmap_allocator<char>::threshold, bmstu::default_init);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(&vec[0]) % bmstu::mmap_allocator<char>::huge_page_size, 0);
+    vec[vec.size() - 1] = 'x';
+    ASSERT_EQ(vec[vec.size() - 1], 'x');
+}
+
+TEST(MmapAllocator, ReallocatedBlocksStayHugePageAligned) {
+    using allocator = bmstu::mmap_allocator<char, 1 << 16>;
+    allocator alloc;
+    std::vector<std::pair<char *, size_t>> neighbours;
+    size_t n = allocator::huge_page_size;
+    char *block = alloc.allocate(n);
+    block[0] = 'a';
+    for (int i = 0; i < 16; ++i) {
+        const size_t gap = (i % 3 + 1) * bmstu::numa::page_size();
+        neighbours.emplace_back(static_cast<char *>(mmap(nullptr, gap, PROT_READ | PROT_WRITE,
+                                                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)), gap);
+        neighbours.emplace_back(alloc.allocate(allocator::huge_page_size), allocator::huge_page_size);
+        block = alloc.reallocate(block, n, n + allocator::huge_page_size);
+        n += allocator::huge_page_size;
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(block) % allocator::huge_page_size, 0);
+        ASSERT_EQ(block[0], 'a');
+        block[n - 1] = 'z';
+    }
+    alloc.deallocate(block, n);
+    for (auto [ptr, size]: neighbours) {
+        if (size == allocator::huge_page_size) {
+            alloc.deallocate(ptr, size);
+        } else {
+            munmap(ptr, size);
+        }
+    }
+}
+
+TEST(MmapAllocator, PageAwareGrowthUsesWholeMapping) {
+    using allocator = bmstu::mmap_allocator<int, 1 << 16>;
+    bmstu::vector<int, allocator, bmstu::grow_page_aware<>> vec;
+    for (int i = 0; i < 100000; ++i) {
+        vec.push_back(i);
+    }
+    ASSERT_EQ(vec.capacity() * sizeof(int) % allocator::huge_page_size, 0);
+    ASSERT_EQ(vec[99999], 99999);
+}
+
+TEST(MmapAllocator, NonRelocatableTypes) {
+    bmstu::vector<std::string, bmstu::mmap_allocator<std::string, 4096>> vec;
+    for (int i = 0; i < 1000; ++i) {
+        vec.push_back(std::to_string(i));
+    }
+    ASSERT_EQ(vec[999], "999");
+}
+
+struct MappedRecord {
+    int64_t id;
+    double value;
+    char tag[4];
+};
+
+static std::string mapped_path(const char *name) {
+    std::string path = testing::TempDir() + name;
+    std::remove(path.c_str());
+    return path;
+}
+
+TEST(MappedVector, PersistsAcrossReopen) {
+    const std::string path = mapped_path("bmstu_mapped_persist.bin");
+    {
+        bmstu::mapped_vector<MappedRecord> vec(path);
+        ASSERT_TRUE(vec.empty());
+        for (int i = 0; i < 10000; ++i) {
+            vec.push_back({i, i * 0.5, {'a', 'b', 'c', '\0'}});
+        }
+        vec.flush();
+    }
+    bmstu::mapped_vector<MappedRecord> vec(path, bmstu::open_mode::read_only);
+    const auto &view = vec;
+    ASSERT_TRUE(vec.read_only());
+    ASSERT_EQ(vec.size(), 10000);
+    ASSERT_GE(vec.capacity(), 10000);
+    ASSERT_EQ(view[9999].id, 9999);
+    ASSERT_EQ(view.at(42).value, 21.0);
+    ASSERT_STREQ(view[0].tag, "abc");
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(view.data()) % alignof(MappedRecord), 0);
+    ASSERT_THROW(vec.push_back({}), std::logic_error);
+    ASSERT_THROW(vec.data(), std::logic_error);
+    ASSERT_THROW(vec.begin(), std::logic_error);
+    ASSERT_THROW(vec[0].id = 1, std::logic_error);
+    ASSERT_THROW(vec.at(0), std::logic_error);
+    bmstu::mapped_vector<MappedRecord> moved(std::move(vec));
+    ASSERT_EQ(moved.size(), 10000);
+    ASSERT_EQ(vec.size(), 0);
+    ASSERT_TRUE(vec.empty());
+    ASSERT_EQ(vec.capacity(), 0);
+    ASSERT_EQ(std::as_const(vec).begin(), std::as_const(vec).end());
+    std::remove(path.c_str());
+}
+
+TEST(MappedVector, GrowsAndReopensForWriting) {
+    const std::string path = mapped_path("bmstu_mapped_grow.bin");
+    {
+        bmstu::mapped_vector<int> vec(path);
+        vec.resize(100);
+        ASSERT_EQ(vec[99], 0);
+        vec.reserve(1000);
+        ASSERT_EQ(vec.capacity(), 1000);
+    }
+    {
+        bmstu::mapped_vector<int> vec(path);
+        ASSERT_EQ(vec.size(), 100);
+        ASSERT_EQ(vec.capacity(), 1000);
+        for (int i = 0; i < 5000; ++i) {
+            vec.emplace_back(i);
+        }
+        vec.pop_back();
+    }
+    const bmstu::mapped_vector<int> vec(path, bmstu::open_mode::read_only);
+    ASSERT_EQ(vec.size(), 5099);
+    ASSERT_EQ(*(vec.end() - 1), 4998);
+    ASSERT_EQ(std::accumulate(vec.begin(), vec.begin() + 100, 0), 0);
+    std::remove(path.c_str());
+}
+
+TEST(MappedVector, PushBackOwnElementAtCapacity) {
+    const std::string path = mapped_path("bmstu_mapped_alias.bin");
+    bmstu::mapped_vector<int> vec(path);
+    vec.push_back(7);
+    std::vector<bmstu::vector<int>> neighbours;
+    for (int round = 0; round < 12; ++round) {
+        while (vec.size() != vec.capacity()) {
+            vec.push_back(round);
+        }
+        // Allocations made after the mapping make it more likely that growing has to move it.
+        neighbours.emplace_back(size_t{1} << 14);
+        vec.push_back(vec[0]);
+        ASSERT_EQ(*(vec.end() - 1), 7);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(MappedVector, RejectsMismatchedFiles) {
+    const std::string path = mapped_path("bmstu_mapped_mismatch.bin");
+    {
+        bmstu::mapped_vector<int> vec(path);
+        vec.push_back(1);
+    }
+    ASSERT_THROW(bmstu::mapped_vector<double>(path, bmstu::open_mode::read_only), std::runtime_error);
+    ASSERT_THROW(bmstu::mapped_vector<int>(path + ".missing", bmstu::open_mode::read_only), std::system_error);
+    FILE *file = std::fopen(path.c_str(), "r+b");
+    std::fputs("garbage", file);
+    std::fclose(file);
+    ASSERT_THROW(bmstu::mapped_vector<int>(path, bmstu::open_mode::read_only), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+TEST(Serialization, TriviallyCopyableRoundTrip) {
+    bmstu::vector<MappedRecord> vec;
+    for (int i = 0; i < 1000; ++i) {
+        vec.push_back(MappedRecord{i, i * 0.25, {'x', 'y', '\0', '\0'}});
+    }
+    std::stringstream stream;
+    bmstu::write_to(vec, stream);
+    ASSERT_EQ(stream.str().size(), sizeof(bmstu::serial_header) + 1000 * sizeof(MappedRecord));
+    bmstu::vector<MappedRecord> copy{{7, 7.0, {}}};
+    bmstu::read_from(copy, stream);
+    ASSERT_EQ(copy.size(), 1000);
+    ASSERT_EQ(copy[999].id, 999);
+    ASSERT_EQ(copy[4].value, 1.0);
+    ASSERT_STREQ(copy[0].tag, "xy");
+}
+
+TEST(Serialization, CustomizationPointThroughFd) {
+    using nested = bmstu::vector<bmstu::vector<std::string>>;
+    nested vec;
+    for (int i = 0; i < 100; ++i) {
+        vec.emplace_back();
+        for (int j = 0; j < i; ++j) {
+            vec[i].push_back(std::string(j, 'a') + std::to_string(j));
+        }
+    }
+    vec.emplace_back();
+    FILE *file = std::tmpfile();
+    bmstu::write_to(vec, fileno(file));
+    bmstu::write_to(bmstu::vector<int>{1, 2, 3}, fileno(file));
+    std::rewind(file);
+    nested copy;
+    bmstu::read_from(copy, fileno(file));
+    std::fclose(file);
+    ASSERT_EQ(copy.size(), 101);
+    ASSERT_TRUE(copy[100].empty());
+    ASSERT_EQ(copy[99].size(), 99);
+    ASSERT_EQ(copy[99][98], std::string(98, 'a') + "98");
+    ASSERT_TRUE(copy == vec);
+}
+
+TEST(Serialization, LargeFdRoundTrip) {
+    bmstu::vector<int> vec(3 * bmstu::fd_sink::buffer_size + 17, bmstu::default_init);
+    std::iota(vec.begin(), vec.end(), 0);
+    FILE *file = std::tmpfile();
+    bmstu::write_to(vec, fileno(file));
+    std::rewind(file);
+    bmstu::vector<int> copy;
+    bmstu::read_from(copy, fileno(file));
+    std::fclose(file);
+    ASSERT_TRUE(copy == vec);
+}
+
+TEST(Serialization, BackToBackOnOneFd) {
+    const bmstu::vector<std::string> words{"alpha", "beta", "gamma"};
+    const bmstu::vector<int> numbers{1, 2, 3};
+    FILE *file = std::tmpfile();
+    bmstu::write_to(words, fileno(file));
+    bmstu::write_to(numbers, fileno(file));
+    bmstu::write_to(words, fileno(file));
+    std::rewind(file);
+    bmstu::vector<std::string> first;
+    bmstu::vector<int> second;
+    bmstu::vector<std::string> third;
+    bmstu::read_from(first, fileno(file));
+    bmstu::read_from(second, fileno(file));
+    bmstu::read_from(third, fileno(file));
+    std::fclose(file);
+    ASSERT_TRUE(first == words);
+    ASSERT_TRUE(second == numbers);
+    ASSERT_TRUE(third == words);
+
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    bmstu::write_to(numbers, fds[1]);
+    bmstu::write_to(bmstu::vector<int>{4, 5}, fds[1]);
+    close(fds[1]);
+    bmstu::vector<int> from_pipe;
+    bmstu::read_from(from_pipe, fds[0]);
+    ASSERT_TRUE(from_pipe == numbers);
+    bmstu::read_from(from_pipe, fds[0]);
+    ASSERT_TRUE(from_pipe == (bmstu::vector<int>{4, 5}));
+    close(fds[0]);
+
+    ASSERT_EQ(pipe(fds), 0);
+    bmstu::write_to(words, fds[1]);
+    close(fds[1]);
+    bmstu::vector<std::string> from_string_pipe;
+    bmstu::read_from(from_string_pipe, fds[0]);
+    ASSERT_TRUE(from_string_pipe == words);
+    close(fds[0]);
+    ASSERT_EQ(pipe(fds), 0);
+    bmstu::write_to(words, fds[1]);
+    bmstu::write_to(numbers, fds[1]);
+    close(fds[1]);
+    ASSERT_THROW(bmstu::read_from(from_string_pipe, fds[0]), std::system_error);
+    close(fds[0]);
+}
+
+TEST(Serialization, RejectsMismatchedInput) {
+    std::stringstream stream;
+    bmstu::write_to(bmstu::vector<int>{1, 2, 3}, stream);
+    const std::string bytes = stream.str();
+    bmstu::vector<double> doubles;
+    std::stringstream as_doubles(bytes);
+    ASSERT_THROW(bmstu::read_from(doubles, as_doubles), std::runtime_error);
+    bmstu::vector<std::string> strings;
+    std::stringstream as_strings(bytes);
+    ASSERT_THROW(bmstu::read_from(strings, as_strings), std::runtime_error);
+    bmstu::vector<int> ints;
+    std::stringstream truncated(bytes.substr(0, bytes.size() - 1));
+    ASSERT_THROW(bmstu::read_from(ints, truncated), std::runtime_error);
+    std::stringstream garbage("definitely not a vector");
+    ASSERT_THROW(bmstu::read_from(ints, garbage), std::runtime_error);
+}
+
+template<typename T>
+static void check_against_std(size_t size) {
+    std::vector<T> expected(size);
+    for (size_t i = 0; i < size; ++i) {
+        expected[i] = static_cast<T>(i % 7);
+    }
+    bmstu::vector<T> vec(expected.begin(), expected.end());
+    for (size_t i = 0; i < size; ++i) {
+        bmstu::vector<T> other = vec;
+        other[i] = static_cast<T>(100);
+        ASSERT_FALSE(vec == other);
+        ASSERT_TRUE(vec < other);
+        ASSERT_TRUE((vec <=> other) < 0);
+        ASSERT_EQ(other.find(static_cast<T>(100)) - other.begin(), i);
+        ASSERT_EQ(other.count(static_cast<T>(100)), 1);
+    }
+    bmstu::vector<T> prefix(expected.begin(), expected.begin() + size / 2);
+    ASSERT_EQ(prefix < vec, size != 0);
+    ASSERT_TRUE((vec <=> vec) == 0);
+    ASSERT_EQ(vec.count(static_cast<T>(3)), std::count(expected.begin(), expected.end(), static_cast<T>(3)));
+    ASSERT_EQ(vec.contains(static_cast<T>(6)), size > 6);
+    ASSERT_EQ(vec.find(static_cast<T>(42)), vec.end());
+}
+
+TEST(SimdCompare, MatchesScalarResults) {
+    for (size_t size: {0, 1, 7, 15, 16, 17, 31, 32, 33, 64, 100, 257}) {
+        check_against_std<char>(size);
+        check_against_std<uint16_t>(size);
+        check_against_std<int>(size);
+        check_against_std<int64_t>(size);
+    }
+}
+
+TEST(SimdCompare, KernelsAgree) {
+    std::vector<uint8_t> a(300, 1), b(300, 1);
+    b[250] = 2;
+    ASSERT_EQ(bmstu::simd::detail::mismatch_sse2(a.data(), b.data(), a.size()), 250);
+    std::vector<uint64_t> lanes(41, 5);
+    lanes[33] = 9;
+    auto *bytes = reinterpret_cast<const unsigned char *>(lanes.data());
+    ASSERT_EQ(bmstu::simd::detail::find_sse2<8>(bytes, lanes.size(), 9), 33);
+    ASSERT_EQ(bmstu::simd::detail::count_sse2<8>(bytes, lanes.size(), 5), 40);
+    if (bmstu::simd::has_avx2()) {
+        ASSERT_EQ(bmstu::simd::detail::mismatch_avx2(a.data(), b.data(), a.size()), 250);
+        ASSERT_EQ(bmstu::simd::detail::find_avx2<8>(bytes, lanes.size(), 9), 33);
+        ASSERT_EQ(bmstu::simd::detail::count_avx2<8>(bytes, lanes.size(), 5), 40);
+    }
+}
+
+TEST(SimdCompare, NonBitwiseTypesUseElementComparison) {
+    bmstu::vector<double> zeros{0.0, 1.0};
+    bmstu::vector<double> negative_zeros{-0.0, 1.0};
+    ASSERT_TRUE(zeros == negative_zeros);
+    ASSERT_TRUE((zeros <=> negative_zeros) == std::partial_ordering::equivalent);
+    ASSERT_EQ(negative_zeros.count(0.0), 1);
+    bmstu::vector<std::string> words{"a", "b", "c"};
+    ASSERT_TRUE((words <=> bmstu::vector<std::string>{"a", "c"}) < 0);
+    ASSERT_TRUE(words.contains("c"));
+    ASSERT_EQ(words.find("b") - words.begin(), 1);
+}
+
+TEST(Parallel, FillForEachReduce) {
+    bmstu::parallel::thread_pool pool(4);
+    const size_t n = 8 * bmstu::parallel::serial_threshold + 3;
+    bmstu::vector<uint64_t> vec(n, bmstu::default_init);
+    bmstu::parallel::fill(vec, 2, pool);
+    ASSERT_EQ(vec.count(2), n);
+    size_t index = 0;
+    for (auto &value: vec) {
+        value = index++;
+    }
+    bmstu::parallel::for_each(vec, [](uint64_t &value) { value *= 3; }, pool);
+    ASSERT_EQ(vec[n - 1], 3 * (n - 1));
+    ASSERT_EQ(bmstu::parallel::reduce(vec, uint64_t{7}, std::plus<>(), pool), 7 + 3 * (n - 1) * n / 2);
+    bmstu::vector<uint64_t> small{1, 2, 3};
+    ASSERT_EQ(bmstu::parallel::reduce(small, uint64_t{0}), 6);
+}
+
+TEST(Parallel, TransformIntoOtherType) {
+    bmstu::parallel::thread_pool pool(4);
+    bmstu::vector<int> src(4 * bmstu::parallel::serial_threshold, bmstu::default_init);
+    std::iota(src.begin(), src.end(), 0);
+    bmstu::vector<std::string> dst{"stale"};
+    bmstu::parallel::transform(src, dst, [](int value) { return std::to_string(value); }, pool);
+    ASSERT_EQ(dst.size(), src.size());
+    ASSERT_EQ(dst[0], "0");
+    ASSERT_EQ(dst[src.size() - 1], std::to_string(src.size() - 1));
+}
+
+TEST(Parallel, SortMatchesStdSort) {
+    bmstu::parallel::thread_pool pool(4);
+    for (size_t n: {size_t{0}, size_t{100}, 16 * bmstu::parallel::serial_threshold + 11}) {
+        std::vector<int> expected(n);
+        uint32_t state = 12345;
+        for (auto &value: expected) {
+            state = state * 1664525 + 1013904223;
+            value = static_cast<int>(state >> 8);
+        }
+        bmstu::vector<int> vec(expected.begin(), expected.end());
+        std::sort(expected.begin(), expected.end());
+        bmstu::parallel::sort(vec, std::less<>(), pool);
+        ASSERT_TRUE(std::equal(vec.begin(), vec.end(), expected.begin(), expected.end()));
+    }
+}
+
+TEST(Parallel, CopyAndAssign) {
+    bmstu::parallel::thread_pool pool(4);
+    bmstu::vector<int> ints(5 * bmstu::parallel::serial_threshold, bmstu::default_init);
+    std::iota(ints.begin(), ints.end(), 0);
+    ASSERT_TRUE(bmstu::parallel::copy(ints, pool) == ints);
+    bmstu::vector<std::string> strings(2 * bmstu::parallel::serial_threshold);
+    strings[12345] = "needle";
+    bmstu::vector<std::string> target{"x", "y"};
+    bmstu::parallel::assign(target, strings, pool);
+    ASSERT_TRUE(target == strings);
+    bmstu::vector<NoDefaultConstructable> no_default{NoDefaultConstructable(1), NoDefaultConstructable(2)};
+    ASSERT_TRUE(bmstu::parallel::copy(no_default, pool) == no_default);
+}
+
+TEST(Parallel, PropagatesExceptionsAndNestsSerially) {
+    bmstu::parallel::thread_pool pool(4);
+    std::atomic<size_t> calls{0};
+    ASSERT_THROW(pool.run(1000, [&](size_t i) {
+        ++calls;
+        if (i == 10) {
+            throw std::runtime_error("task failed");
+        }
+    }), std::runtime_error);
+    ASSERT_LE(calls.load(), 1000);
+    std::atomic<size_t> inner{0};
+    pool.run(8, [&](size_t) {
+        pool.run(8, [&](size_t) { ++inner; });
+    });
+    ASSERT_EQ(inner.load(), 64);
+}
+
+TEST(Parallel, RunPerThreadGivesEachThreadItsIndex) {
+    bmstu::parallel::thread_pool pool(4);
+    for (int round = 0; round < 3; ++round) {
+        std::vector<std::thread::id> threads(pool.concurrency());
+        std::atomic<size_t> calls{0};
+        pool.run_per_thread([&](size_t i) {
+            threads[i] = std::this_thread::get_id();
+            ++calls;
+        });
+        ASSERT_EQ(calls.load(), pool.concurrency());
+        ASSERT_EQ(threads[0], std::this_thread::get_id());
+        for (size_t i = 1; i < threads.size(); ++i) {
+            ASSERT_EQ(std::count(threads.begin(), threads.end(), threads[i]), 1);
+        }
+    }
+    for (int round = 0; round < 2000; ++round) {
+        std::atomic<size_t> tasks{0};
+        pool.run(3, [&](size_t) { ++tasks; });
+        std::vector<std::atomic<int>> per_index(pool.concurrency());
+        pool.run_per_thread([&](size_t i) { ++per_index[i]; });
+        ASSERT_EQ(tasks.load(), 3);
+        for (auto &calls: per_index) {
+            ASSERT_EQ(calls.load(), 1);
+        }
+    }
+    std::atomic<size_t> inner{0};
+    pool.run_per_thread([&](size_t) {
+        pool.run_per_thread([&](size_t) { ++inner; });
+    });
+    ASSERT_EQ(inner.load(), pool.concurrency() * pool.concurrency());
+}
+
+TEST(ConcurrentVector, ReferencesStayStable) {
+    bmstu::concurrent_vector<std::string> vec;
+    std::string &first = vec.push_back("first");
+    const std::string *address = &first;
+    for (int i = 0; i < 10000; ++i) {
+        vec.emplace_back(std::to_string(i));
+    }
+    ASSERT_EQ(&vec[0], address);
+    ASSERT_EQ(first, "first");
+    ASSERT_EQ(vec.size(), 10001);
+    ASSERT_EQ(vec.at(10000), "9999");
+    ASSERT_THROW(vec.at(10001), std::out_of_range);
+    auto it = vec.grow_by(3, "x");
+    ASSERT_EQ(it - vec.begin(), 10001);
+    ASSERT_EQ(vec.end() - it, 3);
+    ASSERT_EQ(*(vec.end() - 1), "x");
+    ASSERT_TRUE(vec.grow_by(2)->empty());
+}
+
+TEST(ConcurrentVector, ConcurrentAppendsAndReads) {
+    constexpr size_t writers = 8;
+    constexpr size_t per_writer = 20000;
+    bmstu::concurrent_vector<uint64_t> vec;
+    std::atomic<bool> done{false};
+    std::thread reader([&] {
+        uint64_t checked = 0;
+        while (!done.load()) {
+            const size_t n = vec.size();
+            for (size_t i = checked; i < n; ++i) {
+                ASSERT_LT(vec[i], writers * per_writer);
+            }
+            checked = n;
+        }
+    });
+    std::vector<std::thread> threads;
+    for (size_t w = 0; w < writers; ++w) {
+        threads.emplace_back([&vec, w] {
+            for (size_t i = 0; i < per_writer; ++i) {
+                if (i % 100 == 0) {
+                    vec.grow_by(1, w * per_writer + i);
+                } else {
+                    vec.push_back(w * per_writer + i);
+                }
+            }
+        });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    done = true;
+    reader.join();
+    ASSERT_EQ(vec.size(), writers * per_writer);
+    std::vector<uint64_t> values(vec.begin(), vec.end());
+    std::sort(values.begin(), values.end());
+    for (size_t i = 0; i < values.size(); ++i) {
+        ASSERT_EQ(values[i], i);
+    }
+}
+
+TEST(ConcurrentVector, ReserveAndIteration) {
+    bmstu::concurrent_vector<int> vec;
+    vec.reserve(1000);
+    ASSERT_TRUE(vec.empty());
+    for (int i = 0; i < 1000; ++i) {
+        vec.push_back(i);
+    }
+    const auto &view = vec;
+    ASSERT_EQ(std::accumulate(view.begin(), view.end(), 0), 999 * 1000 / 2);
+    ASSERT_EQ(std::find(view.begin(), view.end(), 512) - view.begin(), 512);
+}
+
+TEST(ConcurrentVector, SegmentsUseTheVectorsAllocator) {
+    std::array<std::byte, 1 << 16> buffer{};
+    std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+    {
+        bmstu::concurrent_vector<int, std::pmr::polymorphic_allocator<int>> vec(&arena);
+        for (int i = 0; i < 1000; ++i) {
+            vec.push_back(i);
+        }
+        auto *first = reinterpret_cast<std::byte *>(&vec[0]);
+        ASSERT_TRUE(first >= buffer.data() && first < buffer.data() + buffer.size());
+        ASSERT_EQ(vec[999], 999);
+    }
+    TrackingAllocator<int> alloc(3);
+    {
+        bmstu::concurrent_vector<int, TrackingAllocator<int>> vec(alloc);
+        vec.grow_by(100, 7);
+        ASSERT_EQ(vec.get_allocator().id, 3);
+    }
+    ASSERT_GT(*alloc.allocations, 0);
+}
+
+TEST(StableVector, GrowthNeverMovesElements) {
+    bmstu::stable_vector<std::string, 8> vec;
+    std::vector<const std::string *> addresses;
+    for (int i = 0; i < 1000; ++i) {
+        addresses.push_back(&vec.emplace_back(std::to_string(i)));
+    }
+    vec.resize(5000);
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_EQ(&vec[i], addresses[i]);
+        ASSERT_EQ(vec[i], std::to_string(i));
+    }
+    ASSERT_EQ(vec.capacity() % decltype(vec)::chunk_size, 0);
+    ASSERT_EQ(bmstu::stable_vector<int>::chunk_size, 1024);
+}
+
+TEST(StableVector, ChunkTablesUseTheAllocator) {
+    std::array<std::byte, 1 << 16> buffer{};
+    std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+    using pmr_stable = bmstu::stable_vector<int, 16, std::pmr::polymorphic_allocator<int>>;
+    pmr_stable vec(&arena);
+    for (int i = 0; i < 1000; ++i) {
+        vec.push_back(i);
+    }
+    ASSERT_LT(vec.memory_usage(), buffer.size());
+    pmr_stable other({1, 2, 3}, &arena);
+    other.swap(vec);
+    ASSERT_EQ(other.size(), 1000);
+    ASSERT_EQ(vec.size(), 3);
+
+    pmr_stable elsewhere(std::pmr::new_delete_resource());
+    elsewhere = other;
+    ASSERT_EQ(elsewhere.get_allocator().resource(), std::pmr::new_delete_resource());
+    ASSERT_TRUE(std::equal(elsewhere.begin(), elsewhere.end(), other.begin(), other.end()));
+    elsewhere = std::move(vec);
+    ASSERT_EQ(elsewhere.get_allocator().resource(), std::pmr::new_delete_resource());
+    ASSERT_EQ(elsewhere.size(), 3);
+    ASSERT_EQ(elsewhere[2], 3);
+
+    bmstu::stable_vector<int, 16, TrackingAllocator<int>> tracked(TrackingAllocator<int>(5));
+    tracked.resize(100);
+    const size_t allocations = *tracked.get_allocator().allocations;
+    ASSERT_GT(allocations, 7);
+    bmstu::stable_vector<int, 16, TrackingAllocator<int>> moved(TrackingAllocator<int>(5));
+    moved = std::move(tracked);
+    ASSERT_EQ(moved.size(), 100);
+    ASSERT_EQ(*moved.get_allocator().allocations, allocations);
+}
+
+TEST(StableVector, RecyclesChunks) {
+    bmstu::stable_vector<int, 16> vec;
+    for (int i = 0; i < 1000; ++i) {
+        vec.push_back(i);
+    }
+    const size_t usage = vec.memory_usage();
+    vec.clear();
+    ASSERT_EQ(vec.capacity(), 0);
+    ASSERT_EQ(vec.memory_usage(), usage);
+    for (int i = 0; i < 1000; ++i) {
+        vec.push_back(i);
+    }
+    ASSERT_EQ(vec.memory_usage(), usage);
+    vec.erase(vec.begin() + 10, vec.end());
+    ASSERT_EQ(vec.capacity(), 16);
+    vec.shrink_to_fit();
+    ASSERT_LT(vec.memory_usage(), usage);
+    ASSERT_EQ(vec.size(), 10);
+    ASSERT_EQ(vec[9], 9);
+}
+
+TEST(CowVector, CopiesShareUntilMutation) {
+    bmstu::cow_vector<std::string> original{"a", "b", "c"};
+    const auto &view = original;
+    const std::string *buffer = view.data();
+    bmstu::cow_vector<std::string> snapshot = original;
+    ASSERT_EQ(original.use_count(), 2);
+    ASSERT_EQ(std::as_const(snapshot).data(), buffer);
+    original.push_back("d");
+    ASSERT_EQ(original.use_count(), 1);
+    ASSERT_EQ(snapshot.use_count(), 1);
+    ASSERT_EQ(std::as_const(snapshot).data(), buffer);
+    ASSERT_EQ(snapshot.size(), 3);
+    ASSERT_EQ(original.size(), 4);
+    bmstu::cow_vector<std::string> second = snapshot;
+    second[0] = "changed";
+    ASSERT_EQ(snapshot[0], "a");
+    ASSERT_EQ(second[0], "changed");
+    second.erase(second.cbegin() + 1);
+    second.incert(second.cbegin(), "front");
+    ASSERT_TRUE(second == (bmstu::cow_vector<std::string>{"front", "changed", "c"}));
+}
+
+TEST(CowVector, ClearAndDefaultStateDoNotAllocate) {
+    bmstu::cow_vector<int> empty;
+    ASSERT_EQ(empty.use_count(), 0);
+    ASSERT_EQ(empty.begin(), empty.end());
+    bmstu::cow_vector<int> vec(bmstu::vector<int>{1, 2, 3});
+    bmstu::cow_vector<int> copy = vec;
+    copy.clear();
+    ASSERT_TRUE(copy.empty());
+    ASSERT_EQ(vec.size(), 3);
+    ASSERT_EQ(vec.use_count(), 1);
+    vec.clear();
+    ASSERT_TRUE(vec.empty());
+}
+
+TEST(CowVector, PayloadKeepsTheAllocator) {
+    bmstu::cow_vector<int, TrackingAllocator<int>> vec(TrackingAllocator<int>(7));
+    ASSERT_EQ(vec.get_allocator().id, 7);
+    vec.push_back(1);
+    ASSERT_EQ(vec.get_allocator().id, 7);
+    bmstu::cow_vector<int, TrackingAllocator<int>> copy = vec;
+    copy.push_back(2);
+    ASSERT_EQ(copy.get_allocator().id, 7);
+    ASSERT_EQ(vec.size(), 1);
+    ASSERT_EQ(copy.size(), 2);
+    copy.swap(vec);
+    ASSERT_EQ(vec.size(), 2);
+
+    std::array<std::byte, 1 << 14> buffer{};
+    std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+    const auto in_arena = [&](const void *ptr) {
+        const auto *byte = static_cast<const std::byte *>(ptr);
+        return byte >= buffer.data() && byte < buffer.data() + buffer.size();
+    };
+    bmstu::cow_vector<int, std::pmr::polymorphic_allocator<int>> pmr_vec(&arena);
+    pmr_vec.push_back(1);
+    auto pmr_copy = pmr_vec;
+    pmr_copy.push_back(2);
+    pmr_copy.swap(pmr_vec);
+    ASSERT_TRUE(in_arena(&*pmr_vec.begin()) && in_arena(&*pmr_copy.begin()));
+    ASSERT_EQ(pmr_vec.size(), 2);
+    bmstu::persistent_vector<int, 4, std::pmr::polymorphic_allocator<int>> persistent(&arena);
+    for (int i = 0; i < 10; ++i) {
+        persistent.push_back(i);
+    }
+    auto snapshot = persistent;
+    persistent.set(0, 100);
+    ASSERT_EQ(snapshot[0], 0);
+    ASSERT_EQ(persistent[0], 100);
+    ASSERT_TRUE(in_arena(&persistent[9]));
+}
+
+TEST(CowVector, SnapshotsAcrossThreads) {
+    bmstu::cow_vector<int> table(10000);
+    std::vector<std::thread> readers;
+    std::atomic<long> total{0};
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([snapshot = table, &total] {
+            total += std::accumulate(snapshot.begin(), snapshot.end(), 0L);
+        });
+    }
+    for (int i = 0; i < 10000; ++i) {
+        table[i] = 1;
+    }
+    for (auto &reader: readers) {
+        reader.join();
+    }
+    ASSERT_EQ(total.load(), 0);
+    ASSERT_EQ(std::accumulate(std::as_const(table).begin(), std::as_const(table).end(), 0L), 10000);
+}
+
+TEST(PersistentVector, MutationCopiesOneChunk) {
+    bmstu::persistent_vector<int, 64> vec;
+    for (int i = 0; i < 1000; ++i) {
+        vec.push_back(i);
+    }
+    const auto snapshot = vec;
+    ASSERT_EQ(vec.shared_chunks(snapshot), 16);
+    vec.set(500, -1);
+    ASSERT_EQ(vec[500], -1);
+    ASSERT_EQ(snapshot[500], 500);
+    ASSERT_EQ(vec.shared_chunks(snapshot), 15);
+    vec.mutable_at(501) = -2;
+    ASSERT_EQ(vec.shared_chunks(snapshot), 15);
+    vec.pop_back();
+    ASSERT_EQ(vec.size(), 999);
+    ASSERT_EQ(snapshot.size(), 1000);
+    ASSERT_EQ(snapshot[999], 999);
+    ASSERT_EQ(vec.shared_chunks(snapshot), 14);
+    ASSERT_EQ(std::accumulate(snapshot.begin(), snapshot.end(), 0), 999 * 1000 / 2);
+    ASSERT_THROW(vec.mutable_at(999), std::out_of_range);
+}
+
+TEST(PersistentVector, ChunkBoundaries) {
+    bmstu::persistent_vector<std::string, 4> vec{"a", "b", "c", "d"};
+    auto copy = vec;
+    vec.push_back("e");
+    ASSERT_EQ(vec.shared_chunks(copy), 1);
+    vec.pop_back();
+    ASSERT_TRUE(vec == copy);
+    while (!vec.empty()) {
+        vec.pop_back();
+    }
+    ASSERT_EQ(copy.size(), 4);
+    ASSERT_EQ(copy.at(3), "d");
+}
+
+struct LargeElement {
+    std::array<char, 600> padding{};
+    int value = 0;
+
+    friend bool operator==(const LargeElement &l, const LargeElement &r) {
+        return l.value == r.value;
+    }
+};
+
+template<typename Vec>
+void check_push_pop_against_model(Vec &vec) {
+    std::vector<int> model;
+    for (int round = 0; round < 50; ++round) {
+        for (int i = 0; i < round % 7 + 1; ++i) {
+            vec.push_back(typename Vec::value_type{{}, round * 10 + i});
+            model.push_back(round * 10 + i);
+        }
+        for (int i = 0; i < round % 5 && !model.empty(); ++i) {
+            vec.pop_back();
+            model.pop_back();
+        }
+        ASSERT_EQ(vec.size(), model.size());
+        for (size_t i = 0; i < model.size(); ++i) {
+            ASSERT_EQ(vec[i].value, model[i]);
+        }
+    }
+}
+
+TEST(PersistentVector, SingleElementChunks) {
+    struct Small {
+        std::array<char, 1> padding;
+        int value;
+    };
+    bmstu::persistent_vector<Small, 1> vec;
+    check_push_pop_against_model(vec);
+    static_assert(bmstu::persistent_vector<LargeElement>::chunk_size == 1);
+    bmstu::persistent_vector<LargeElement> large;
+    check_push_pop_against_model(large);
+    auto copy = large;
+    large.pop_back();
+    large.push_back(LargeElement{{}, -1});
+    ASSERT_EQ(large[large.size() - 1].value, -1);
+    ASSERT_NE(copy[copy.size() - 1].value, -1);
+}
+
+TEST(SoaVector, ColumnsAndRows) {
+    bmstu::soa_vector<int, double, std::string> vec;
+    for (int i = 0; i < 100; ++i) {
+        vec.emplace_back(i, i * 0.5, std::to_string(i));
+    }
+    vec.push_back({100, 50.0, "100"});
+    ASSERT_EQ(vec.size(), 101);
+    ASSERT_GE(vec.capacity(), 101);
+    std::span<int> keys = vec.column<0>();
+    ASSERT_EQ(keys.size(), 101);
+    ASSERT_EQ(std::accumulate(keys.begin(), keys.end(), 0), 5050);
+    auto [key, weight, name] = vec[42];
+    ASSERT_EQ(key, 42);
+    ASSERT_EQ(weight, 21.0);
+    ASSERT_EQ(name, "42");
+    weight = -1.0;
+    std::get<2>(vec.at(7)) = "seven";
+    ASSERT_EQ(vec.column<1>()[42], -1.0);
+    ASSERT_EQ(vec.column<2>()[7], "seven");
+    ASSERT_THROW(vec.at(101), std::out_of_range);
+    int expected = 0;
+    for (auto [k, w, n]: std::as_const(vec)) {
+        ASSERT_EQ(k, expected++);
+    }
+    ASSERT_EQ(expected, 101);
+}
+
+TEST(SoaVector, EraseResizeAndCopy) {
+    bmstu::soa_vector<int, std::unique_ptr<int>> owners;
+    for (int i = 0; i < 10; ++i) {
+        owners.emplace_back(i, std::make_unique<int>(i * i));
+    }
+    owners.erase(owners.begin() + 2, owners.begin() + 5);
+    ASSERT_EQ(owners.size(), 7);
+    ASSERT_EQ(std::get<0>(owners[2]), 5);
+    ASSERT_EQ(*std::get<1>(owners[2]), 25);
+    owners.resize(9);
+    ASSERT_EQ(std::get<1>(owners[8]), nullptr);
+    owners.pop_back();
+    owners.shrink_to_fit();
+    ASSERT_EQ(owners.capacity(), 8);
+
+    bmstu::soa_vector<int, std::string> vec{{1, "a"}, {2, "b"}, {3, "c"}};
+    bmstu::soa_vector<int, std::string> copy(vec);
+    ASSERT_TRUE(copy == vec);
+    std::get<1>(copy[1]) = "x";
+    ASSERT_TRUE(copy != vec);
+    copy = std::move(vec);
+    ASSERT_EQ(std::get<1>(copy[1]), "b");
+    ASSERT_TRUE(vec.empty());
+}
+
+TEST(SoaVector, GrowthFromOwnRow) {
+    bmstu::soa_vector<std::string, int> vec;
+    vec.emplace_back(std::string(64, 'a'), 1);
+    for (int i = 0; i < 20; ++i) {
+        const size_t capacity = vec.capacity();
+        vec.emplace_back(std::get<0>(vec[0]), std::get<1>(vec[0]));
+        if (vec.size() > capacity) {
+            ASSERT_GT(vec.capacity(), capacity);
+        }
+    }
+    for (auto [text, value]: vec) {
+        ASSERT_EQ(text, std::string(64, 'a'));
+        ASSERT_EQ(value, 1);
+    }
+}
+
+TEST(BitVector, ProxyReferences) {
+    bmstu::bit_vector<> bits{true, false, true};
+    for (int i = 0; i < 130; ++i) {
+        bits.push_back(i % 3 == 0);
+    }
+    ASSERT_EQ(bits.size(), 133);
+    ASSERT_EQ(bits.word_count(), 3);
+    ASSERT_TRUE(bits[0]);
+    ASSERT_FALSE(bits[1]);
+    bits[1] = true;
+    bits[2] = bits[4];
+    bits.flip(0);
+    ASSERT_FALSE(bits.test(0));
+    ASSERT_TRUE(bits[1]);
+    ASSERT_FALSE(bits[2]);
+    ASSERT_THROW(bits.set(133), std::out_of_range);
+    size_t set = 0;
+    for (bool bit: std::as_const(bits)) {
+        set += bit;
+    }
+    ASSERT_EQ(set, bits.count());
+    for (auto bit: bits) {
+        bit = true;
+    }
+    ASSERT_TRUE(bits.all());
+    bits.pop_back();
+    bits.resize(200, false);
+    ASSERT_EQ(bits.count(), 132);
+    bits.resize(70);
+    bits.resize(140, true);
+    ASSERT_EQ(bits.count(), 140);
+    std::ostringstream out;
+    out << bmstu::bit_vector<>{true, false};
+    ASSERT_EQ(out.str(), "[1, 0]");
+}
+
+TEST(BitVector, CountAndFind) {
+    bmstu::bit_vector<> bits(1000);
+    ASSERT_TRUE(bits.none());
+    ASSERT_EQ(bits.find_first(), bmstu::bit_vector<>::npos);
+    const std::vector<size_t> positions{3, 63, 64, 65, 500, 999};
+    for (size_t pos: positions) {
+        bits.set(pos);
+    }
+    ASSERT_EQ(bits.count(), positions.size());
+    std::vector<size_t> found;
+    for (size_t pos = bits.find_first(); pos != bmstu::bit_vector<>::npos; pos = bits.find_next(pos)) {
+        found.push_back(pos);
+    }
+    ASSERT_EQ(found, positions);
+    bits.flip();
+    ASSERT_EQ(bits.count(), 1000 - positions.size());
+    ASSERT_EQ(bits.find_first(), 0);
+    ASSERT_EQ(bits.find_next(2), 4);
+    bits.reset();
+    ASSERT_EQ(bits.count(), 0);
+    bits.set();
+    ASSERT_TRUE(bits.all());
+}
+
+TEST(BitVector, BulkOperations) {
+    const size_t n = 1003;
+    bmstu::bit_vector<> evens(n);
+    bmstu::bit_vector<> thirds(n);
+    for (size_t i = 0; i < n; ++i) {
+        evens[i] = i % 2 == 0;
+        thirds[i] = i % 3 == 0;
+    }
+    bmstu::bit_vector<> both = evens & thirds;
+    bmstu::bit_vector<> either = evens | thirds;
+    bmstu::bit_vector<> one = evens ^ thirds;
+    bmstu::bit_vector<> odds = ~evens;
+    for (size_t i = 0; i < n; ++i) {
+        ASSERT_EQ(both[i], i % 6 == 0);
+        ASSERT_EQ(either[i], i % 2 == 0 || i % 3 == 0);
+        ASSERT_EQ(one[i], (i % 2 == 0) != (i % 3 == 0));
+        ASSERT_EQ(odds[i], i % 2 == 1);
+    }
+    ASSERT_EQ(odds.count(), n / 2);
+    ASSERT_TRUE((odds | evens).all());
+    ASSERT_TRUE((odds & evens).none());
+    bmstu::bit_vector<> copy(either);
+    ASSERT_TRUE(copy == either);
+    copy ^= either;
+    ASSERT_TRUE(copy.none());
+    ASSERT_TRUE(copy != either);
+}
+
+size_t total_pages(const bmstu::vector<size_t> &per_node) {
+    return std::accumulate(per_node.begin(), per_node.end(), size_t{0});
+}
+
+TEST(Numa, PoliciesPlaceEveryPage) {
+    ASSERT_GE(bmstu::numa::node_count(), 1);
+    const size_t n = size_t{1} << 18;
+    const size_t pages = n * sizeof(int64_t) / bmstu::numa::page_size();
+    for (auto policy: {bmstu::numa_policy::first_touch, bmstu::numa_policy::interleave, bmstu::numa_policy::bind}) {
+        bmstu::vector<int64_t, bmstu::numa_allocator<int64_t>> vec(n, bmstu::numa_allocator<int64_t>(policy));
+        ASSERT_EQ(vec.get_allocator().policy(), policy);
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(vec.data()) % bmstu::numa::page_size(), 0);
+        const auto per_node = bmstu::numa::pages_per_node(vec.data(), n * sizeof(int64_t));
+        ASSERT_LE(per_node.size(), bmstu::numa::max_nodes);
+        ASSERT_EQ(total_pages(per_node), pages);
+        if (policy == bmstu::numa_policy::bind) {
+            ASSERT_EQ(per_node[0], pages);
+        }
+    }
+}
+
+TEST(Numa, MissingNodeFallsBack) {
+    const size_t node = bmstu::numa::max_nodes - 1;
+    if (bmstu::numa::allowed_nodes() >> node & 1) {
+        GTEST_SKIP();
+    }
+    bmstu::numa_allocator<int> alloc(bmstu::numa_policy::bind, node);
+    int *block = alloc.allocate(1 << 16);
+    ASSERT_FALSE(bmstu::numa::apply(block, (1 << 16) * sizeof(int), bmstu::numa_policy::bind, node));
+    alloc.deallocate(block, 1 << 16);
+    bmstu::vector<int, bmstu::numa_allocator<int>> vec(alloc);
+    for (int i = 0; i < 100000; ++i) {
+        vec.push_back(i);
+    }
+    ASSERT_EQ(vec[99999], 99999);
+    bmstu::vector<int, bmstu::numa_allocator<int>> small({1, 2, 3}, alloc);
+    ASSERT_EQ(small[2], 3);
+}
+
+TEST(Numa, FirstTouchResize) {
+    bmstu::parallel::thread_pool pool(4);
+    bmstu::vector<double, bmstu::numa_allocator<double>> vec;
+    const size_t n = size_t{1} << 20;
+    bmstu::parallel::first_touch_resize(vec, n, 0.5, pool);
+    ASSERT_EQ(vec.size(), n);
+    ASSERT_EQ(std::count(vec.begin(), vec.end(), 0.5), n);
+    const auto per_node = bmstu::numa::pages_per_node(vec.data(), n * sizeof(double));
+    ASSERT_EQ(total_pages(per_node), n * sizeof(double) / bmstu::numa::page_size());
+    bmstu::parallel::first_touch_resize(vec, 10, 1.0, pool);
+    ASSERT_EQ(vec.size(), 10);
+    ASSERT_EQ(vec[9], 0.5);
+}
+
+// Every pool thread is pinned to the CPU it runs on, so block i of the partition must land wholly on the node
+// of thread i. On a single node only the partition itself can be checked.
+TEST(Numa, FirstTouchResizeBlockPerThread) {
+    bmstu::parallel::thread_pool pool(4);
+    const size_t blocks = pool.concurrency();
+    std::vector<unsigned> nodes(blocks);
+    std::vector<cpu_set_t> saved(blocks);
+    std::atomic<bool> pinned{true};
+    pool.run_per_thread([&](size_t i) {
+        unsigned cpu = 0;
+        cpu_set_t one;
+        CPU_ZERO(&one);
+        if (sched_getaffinity(0, sizeof(cpu_set_t), &saved[i]) != 0 || getcpu(&cpu, &nodes[i]) != 0) {
+            pinned = false;
+            return;
+        }
+        CPU_SET(cpu, &one);
+        if (sched_setaffinity(0, sizeof(cpu_set_t), &one) != 0) {
+            pinned = false;
+        }
+    });
+    bmstu::vector<double, bmstu::numa_allocator<double>> vec;
+    const size_t n = size_t{1} << 20;
+    bmstu::parallel::first_touch_resize(vec, n, 0.5, pool);
+    pool.run_per_thread([&](size_t i) { sched_setaffinity(0, sizeof(cpu_set_t), &saved[i]); });
+    const size_t page = bmstu::numa::page_size();
+    const double *first = vec.data();
+    size_t previous = 0;
+    for (size_t i = 0; i < blocks; ++i) {
+        const size_t begin = bmstu::parallel::block_boundary(first, n, blocks, i);
+        const size_t end = bmstu::parallel::block_boundary(first, n, blocks, i + 1);
+        ASSERT_EQ(begin, previous);
+        ASSERT_LE(begin, end);
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(first + begin) % page, 0);
+        ASSERT_NEAR(static_cast<double>(end - begin), static_cast<double>(n / blocks), page / sizeof(double));
+        previous = end;
+        const auto per_node = bmstu::numa::pages_per_node(first + begin, (end - begin) * sizeof(double));
+        ASSERT_EQ(total_pages(per_node), (end - begin) * sizeof(double) / page);
+        if (bmstu::numa::node_count() > 1 && pinned) {
+            ASSERT_LT(nodes[i], per_node.size());
+            ASSERT_EQ(per_node[nodes[i]], total_pages(per_node));
+        }
+    }
+    ASSERT_EQ(previous, n);
+}